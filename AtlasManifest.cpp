@@ -0,0 +1,82 @@
+#include "AtlasManifest.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Função que lê o restante da linha como um caminho, sem o espaço inicial
+static std::string readRest(std::istringstream& line) {
+    std::string rest;
+    std::getline(line >> std::ws, rest);
+    while (!rest.empty() && (rest.back() == '\r' || rest.back() == ' ' || rest.back() == '\t')) {
+        rest.pop_back();
+    }
+    return rest;
+}
+
+// Função que lê o manifesto do atlas
+bool loadAtlasManifest(const std::string& path, AtlasManifest& manifest) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open atlas manifest: " << path << std::endl;
+        return false;
+    }
+
+    manifest = AtlasManifest();
+    std::string text;
+    for (int lineNumber = 1; std::getline(file, text); ++lineNumber) {
+        std::istringstream line(text);
+        std::string kind;
+        if (!(line >> kind) || kind[0] == '#') {
+            continue;
+        }
+
+        bool valid = false;
+        if (kind == "page") {
+            AtlasPage page;
+            valid = (line >> page.width >> page.height) && page.width > 0 && page.height > 0;
+            page.path = readRest(line);
+            if (valid && !page.path.empty()) {
+                manifest.pages.push_back(page);
+                continue;
+            }
+        }
+        else if (kind == "region") {
+            AtlasRegion region;
+            valid = (line >> region.page >> region.x >> region.y >> region.width >> region.height)
+                && region.page >= 0 && region.page < static_cast<int>(manifest.pages.size());
+            region.name = readRest(line);
+            if (valid) {
+                const AtlasPage& page = manifest.pages[region.page];
+                valid = !region.name.empty() && region.x >= 0 && region.y >= 0 && region.width > 0 && region.height > 0
+                    && region.x + region.width <= page.width && region.y + region.height <= page.height;
+            }
+            if (valid) {
+                manifest.regions.push_back(region);
+                continue;
+            }
+        }
+
+        std::cerr << path << ":" << lineNumber << ": invalid atlas entry: " << text << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Função que grava o manifesto do atlas
+bool writeAtlasManifest(const std::string& path, const AtlasManifest& manifest) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create atlas manifest: " << path << std::endl;
+        return false;
+    }
+
+    file << "# Atlas de texturas gerado por tools/AtlasPacker.cpp\n";
+    for (const AtlasPage& page : manifest.pages) {
+        file << "page " << page.width << " " << page.height << " " << page.path << "\n";
+    }
+    for (const AtlasRegion& region : manifest.regions) {
+        file << "region " << region.page << " " << region.x << " " << region.y << " "
+            << region.width << " " << region.height << " " << region.name << "\n";
+    }
+    return static_cast<bool>(file);
+}
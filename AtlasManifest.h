@@ -0,0 +1,38 @@
+#ifndef ATLASMANIFEST_H
+#define ATLASMANIFEST_H
+
+#include <string>
+#include <vector>
+
+// Página do atlas: uma imagem com várias texturas empacotadas
+struct AtlasPage {
+    std::string path;           // Caminho da imagem da página
+    int width = 0, height = 0;  // Dimensões em pixels
+};
+
+// Região de uma textura original dentro de uma página, em pixels a partir do canto superior esquerdo da imagem
+struct AtlasRegion {
+    std::string name;           // Caminho da textura original (o mesmo usado no TextureCache::load)
+    int page = 0;               // Índice da página em AtlasManifest::pages
+    int x = 0, y = 0;           // Canto superior esquerdo da região, sem o preenchimento
+    int width = 0, height = 0;  // Dimensões da textura original
+};
+
+// Manifesto do atlas, sem nenhuma dependência da OpenGL
+// É gerado pela ferramenta de empacotamento (tools/AtlasPacker.cpp) e lido pelo TextureCache::loadAtlas
+// Formato texto, uma entrada por linha ('#' inicia um comentário):
+//   page <largura> <altura> <caminho da imagem>
+//   region <página> <x> <y> <largura> <altura> <nome>
+// O caminho e o nome ficam no fim da linha e podem conter espaços
+struct AtlasManifest {
+    std::vector<AtlasPage> pages;
+    std::vector<AtlasRegion> regions;
+};
+
+// Lê um manifesto; erros de formato são informados com a linha
+bool loadAtlasManifest(const std::string& path, AtlasManifest& manifest);
+
+// Grava um manifesto
+bool writeAtlasManifest(const std::string& path, const AtlasManifest& manifest);
+
+#endif
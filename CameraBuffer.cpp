@@ -0,0 +1,37 @@
+#include "CameraBuffer.h"
+#include <glm/gtc/type_ptr.hpp>
+
+// Construtor da classe CameraBuffer
+// Pelo layout std140 cada mat4 ocupa 64 bytes, sem preenchimento entre as duas matrizes
+CameraBuffer::CameraBuffer() : UBO(0) {
+    glGenBuffers(1, &UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::CAMERA_BLOCK_BINDING, UBO);
+
+    // Começa com as duas matrizes identidade
+    setProjection(glm::mat4(1.0f));
+    setView(glm::mat4(1.0f));
+}
+
+// Destrutor: libera o buffer somente se ainda houver um contexto OpenGL ativo
+CameraBuffer::~CameraBuffer() {
+    if (UBO != 0 && glfwGetCurrentContext() != nullptr) {
+        glDeleteBuffers(1, &UBO);
+    }
+}
+
+// Função que envia a matriz de projeção
+void CameraBuffer::setProjection(const glm::mat4& projection) {
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(projection));
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Função que envia a matriz de visão
+void CameraBuffer::setView(const glm::mat4& view) {
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(view));
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
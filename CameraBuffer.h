@@ -0,0 +1,32 @@
+#ifndef CAMERABUFFER_H
+#define CAMERABUFFER_H
+
+#include <glm/glm.hpp>
+#include "Shader.h"
+
+// Classe dona do uniform buffer do bloco std140 "Camera" (projection e view)
+// Todos os programas que declaram o bloco leem o mesmo buffer, então as matrizes são enviadas
+// uma única vez por frame, e não uma vez por shader
+class CameraBuffer {
+public:
+    // Construtor: cria o buffer e o associa ao ponto Shader::CAMERA_BLOCK_BINDING (precisa de um contexto OpenGL)
+    CameraBuffer();
+
+    // Libera o buffer
+    ~CameraBuffer();
+
+    // O buffer tem um único dono, por isso não pode ser copiado
+    CameraBuffer(const CameraBuffer&) = delete;
+    CameraBuffer& operator=(const CameraBuffer&) = delete;
+
+    // Atualiza a matriz de projeção (normalmente só na inicialização)
+    void setProjection(const glm::mat4& projection);
+
+    // Atualiza a matriz de visão (uma vez por frame)
+    void setView(const glm::mat4& view);
+
+private:
+    GLuint UBO;                 // Uniform buffer com projection (offset 0) e view (offset 64)
+};
+
+#endif
@@ -1,115 +1,167 @@
 // CharacterController.cpp
 
 #include "CharacterController.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
 
 const float TILE_SIZE = 128.0f;
+const size_t CharacterController::MAX_BUFFERED_MOVES;
 
 // Construtor da classe CharacterController
 CharacterController::CharacterController(Shader& shader, const std::string& texturePath, glm::vec3 position, glm::vec3 tilePosition, glm::vec3 size, float rotate, Tilemap& tilemap)
     : Sprite(shader, texturePath, position, tilePosition, size, rotate), tilemap(tilemap), moving(false)
 {
     targetTile = tilePosition;
+    sourceTile = targetTile;
     targetPosition = position;
     offsetX = 0.0f;
     offsetY = 0.0f;
     flipedX = false;
 }
 
-// Mtodo para verificar se o personagem est em movimento
+// Método para verificar se o personagem está em movimento
 bool CharacterController::getMoving() {
     return moving;
 }
 
-// Mtodos para mover o personagem em diferentes direes
-void CharacterController::moveNorth(double time_delta) {
-    moveIfWalkable(targetTile.x, targetTile.y + 1);
-    updateDirection(false, 0.0f);
-}
-
-void CharacterController::moveSouth(double time_delta) {
-    moveIfWalkable(targetTile.x, targetTile.y - 1);
-    updateDirection(true, -15.0f);
-}
-
-void CharacterController::moveWest(double time_delta) {
-    moveIfWalkable(targetTile.x - 1, targetTile.y);
-    updateDirection(false, 15.0f);
-}
-
-void CharacterController::moveEast(double time_delta) {
-    moveIfWalkable(targetTile.x + 1, targetTile.y);
-    updateDirection(true, 0.0f);
+// Deslocamento no tile, espelhamento e rotação do sprite de cada direção (na ordem de MoveDirection)
+struct MoveDirectionInfo {
+    int dx, dy;
+    bool flipX;
+    float rotation;
+};
+
+static const MoveDirectionInfo MOVE_DIRECTIONS[] = {
+    {  0,  1, false,   0.0f },     // MOVE_NORTH
+    {  0, -1, true,  -15.0f },     // MOVE_SOUTH
+    { -1,  0, false,  15.0f },     // MOVE_WEST
+    {  1,  0, true,    0.0f },     // MOVE_EAST
+    { -1,  1, false,   0.0f },     // MOVE_NORTH_WEST
+    {  1,  1, false,   0.0f },     // MOVE_NORTH_EAST
+    { -1, -1, false,   0.0f },     // MOVE_SOUTH_WEST
+    {  1, -1, true,    0.0f }      // MOVE_SOUTH_EAST
+};
+
+// Método que recebe um movimento pedido pela entrada
+bool CharacterController::queueMove(MoveDirection direction, double timestamp, bool repeat) {
+    BufferedMove move = { direction, timestamp, repeat };
+    if (!moving && bufferedMoves.empty()) {
+        startMove(move);
+        return true;
+    }
+    if ((repeat && !bufferedMoves.empty()) || bufferedMoves.size() >= MAX_BUFFERED_MOVES) {
+        return false;
+    }
+    bufferedMoves.push_back(move);
+    return true;
 }
 
-void CharacterController::moveNorthWest(double time_delta) {
-    moveIfWalkable(targetTile.x - 1, targetTile.y + 1);
-    updateDirection(false, 0.0f);
+// Método que descarta as repetições guardadas de uma direção cuja tecla foi solta
+// Os toques separados continuam guardados: só a repetição depende da tecla ainda estar segurada
+void CharacterController::releaseMove(MoveDirection direction) {
+    bufferedMoves.erase(std::remove_if(bufferedMoves.begin(), bufferedMoves.end(), [direction](const BufferedMove& move) {
+        return move.repeat && move.direction == direction;
+    }), bufferedMoves.end());
 }
 
-void CharacterController::moveNorthEast(double time_delta) {
-    moveIfWalkable(targetTile.x + 1, targetTile.y + 1);
-    updateDirection(false, 0.0f);
+// Método que entrega a latência medida desde a última chamada
+InputLatencyStats CharacterController::takeLatencyStats() {
+    InputLatencyStats stats = latencyStats;
+    latencyStats = InputLatencyStats();
+    return stats;
 }
 
-void CharacterController::moveSouthWest(double time_delta) {
-    moveIfWalkable(targetTile.x - 1, targetTile.y - 1);
-    updateDirection(false, 0.0f);
+// Método que vira o personagem e começa o movimento
+// A latência conta do evento de entrada até aqui, quando o personagem de fato começa a andar
+bool CharacterController::startMove(const BufferedMove& move) {
+    const MoveDirectionInfo& info = MOVE_DIRECTIONS[move.direction];
+    moveIfWalkable(targetTile.x + info.dx, targetTile.y + info.dy);
+    updateDirection(info.flipX, info.rotation);
+    updateSprite();
+    if (moving) {
+        latencyStats.add(glfwGetTime() - move.timestamp);
+    }
+    return moving;
 }
 
-void CharacterController::moveSouthEast(double time_delta) {
-    moveIfWalkable(targetTile.x + 1, targetTile.y - 1);
-    updateDirection(true, 0.0f);
+// Método que começa o próximo movimento guardado; os que dão em tiles bloqueados só viram o personagem
+bool CharacterController::startNextBufferedMove() {
+    while (!bufferedMoves.empty()) {
+        BufferedMove move = bufferedMoves.front();
+        bufferedMoves.pop_front();
+        if (startMove(move)) {
+            return true;
+        }
+    }
+    return false;
 }
 
-// Mtodo para mover o personagem se a posio for caminhvel
+// Método para mover o personagem se a posição for caminhável
 void CharacterController::moveIfWalkable(int x, int y) {
-    if (tilemap.isWalkable(x, y)) {
-        auto tile = tilemap.findSpriteByTilePosition(glm::vec3(x, y, 0.0f));
-        if (tile) {
-            targetTile = glm::ivec2(x, y);
-            targetPosition = tile->getPosition();
-            targetPosition.y += 85.0f; // altura do personagem
-
-            tilePosition = tile->getTilePosition();
-            moving = true;
-        }
+    Tile tile;
+    if (tilemap.isWalkable(x, y) && tilemap.getTile(x, y, tile)) {
+        sourceTile = targetTile;
+        targetTile = glm::ivec2(x, y);
+        targetPosition = tile.getPosition();
+        targetPosition.y += 85.0f; // altura do personagem
+
+        tilePosition = tile.getTilePosition();
+        moving = true;
     }
 }
 
-// Mtodo para atualizar a posio do personagem
+// Método para atualizar a posição do personagem
+// O personagem anda exatamente speed * deltaTime por passo: ao chegar no tile, o que sobrou do passo já vale
+// para o próximo movimento guardado, então uma sequência de teclas vira um movimento contínuo
 void CharacterController::update(float deltaTime) {
-    if (moving) {
-        // Determina a direo para mover com base na posio alvo
-        glm::vec3 direction = glm::normalize(targetPosition - position);
-
-        // Move o personagem na direo por uma velocidade fixa escalada por deltaTime
-        float speed = 150.0f; // Ajuste este valor para controlar a velocidade de movimento
-        position += direction * speed * deltaTime;
+    if (!moving) {
+        return;
+    }
 
-        // Verifica se o personagem alcanou a posio alvo
-        if (glm::distance(position, targetPosition) < 1.5f) {
-            position = targetPosition; // Ajusta para a posio alvo
-            moving = false;
+    float speed = 150.0f; // Ajuste este valor para controlar a velocidade de movimento
+    float travel = speed * deltaTime;
+    while (moving && travel > 0.0f) {
+        glm::vec3 toTarget = targetPosition - position;
+        float distance = glm::length(toTarget);
+        if (distance > travel) {
+            position += toTarget / distance * travel;
+            break;
         }
 
-        // Atualiza o sprite com a nova posio
-        updateSprite();
+        // Chegou na posição alvo: segue direto para o próximo movimento guardado, se houver
+        position = targetPosition;
+        travel -= distance;
+        moving = false;
+        startNextBufferedMove();
+    }
+
+    // Atualiza o sprite com a nova posição
+    updateSprite();
+}
+
+// Método que retorna a diagonal do personagem na ordem de pintura
+// Diagonais menores ficam mais perto da câmera e são pintadas depois
+int CharacterController::getDepthDiagonal() const {
+    int target = targetTile.x + targetTile.y;
+    if (!moving) {
+        return target;
     }
+    return std::min(target, sourceTile.x + sourceTile.y);
 }
 
-// Mtodo para atualizar a posio da cmera
+// Método para atualizar a posição da câmera
 glm::vec3 CharacterController::updateCameraPosition(float deltaTime, glm::vec3 cameraPos, GLuint width, GLuint height) {
-    // Define a posio desejada da cmera (centralizada no personagem)
+    // Define a posição desejada da câmera (centralizada no personagem)
     glm::vec3 desiredCameraPos = position - glm::vec3(width / 2, height / 2, 0.0f);
 
-    // Interpola a posio da cmera em direo  posio desejada
+    // Interpola a posição da câmera em direção à posição desejada
     float smoothingFactor = 5.0f; // Ajuste este valor para controlar a suavidade
     cameraPos += (desiredCameraPos - cameraPos) * smoothingFactor * deltaTime;
 
     return cameraPos;
 }
 
-// Mtodo para atualizar a direo do personagem
+// Método para atualizar a direção do personagem
 void CharacterController::updateDirection(bool shouldFlipX, float newRotation) {
     if (flipedX != shouldFlipX) {
         scale.x = -scale.x;
@@ -2,9 +2,23 @@
 #define CHARACTERCONTROLLER_H
 
 #include <glm/glm.hpp>
+#include <deque>
 #include <vector>
 #include "Sprite.h"
 #include "Tilemap.h"
+#include "InputQueue.h"
+
+// Direções de movimento do personagem, uma por tecla
+enum MoveDirection {
+    MOVE_NORTH = 0,
+    MOVE_SOUTH,
+    MOVE_WEST,
+    MOVE_EAST,
+    MOVE_NORTH_WEST,
+    MOVE_NORTH_EAST,
+    MOVE_SOUTH_WEST,
+    MOVE_SOUTH_EAST
+};
 
 // Classe CharacterController que herda de Sprite
 class CharacterController : public Sprite {
@@ -12,40 +26,66 @@ public:
     // Construtor
     CharacterController(Shader& shader, const std::string& texturePath, glm::vec3 position, glm::vec3 tilePosition, glm::vec3 size, float rotate, Tilemap& tilemap);
 
-    // Mtodos para mover o personagem em diferentes direes
-    void moveNorth(double time_delta);
-    void moveSouth(double time_delta);
-    void moveWest(double time_delta);
-    void moveEast(double time_delta);
-    void moveNorthWest(double time_delta);
-    void moveNorthEast(double time_delta);
-    void moveSouthWest(double time_delta);
-    void moveSouthEast(double time_delta);
-
-    // Mtodo para verificar se o personagem est em movimento
+    static const size_t MAX_BUFFERED_MOVES = 3;     // Movimentos guardados enquanto o personagem anda
+
+    // Pede um movimento na direção informada; 'timestamp' é o momento do evento de entrada
+    // Parado, o personagem começa a andar na hora; andando, o movimento é guardado e começa na chegada ao tile,
+    // sem parar. Repetições da tecla segurada só são guardadas com a fila vazia, para não acumular passos
+    // Retorna false se o movimento foi descartado (fila cheia ou repetição)
+    bool queueMove(MoveDirection direction, double timestamp, bool repeat = false);
+
+    // Informa que a tecla da direção foi solta: descarta as repetições ainda guardadas dessa direção, para o
+    // personagem parar no tile em que a tecla foi solta
+    void releaseMove(MoveDirection direction);
+
+    // Retorna e zera a latência dos movimentos iniciados desde a última chamada (uma vez por passo da simulação)
+    InputLatencyStats takeLatencyStats();
+
+    // Método para verificar se o personagem está em movimento
     bool getMoving();
 
-    // Mtodo para atualizar a posio do personagem
+    // Método para atualizar a posição do personagem; ao chegar no tile, o próximo movimento guardado começa
+    // com a distância que sobrou do passo
     void update(float deltaTime);
 
-    // Mtodo para atualizar a posio da cmera
+    // Método que retorna a diagonal usada na ordem de pintura; durante o movimento fica na mais próxima da
+    // câmera entre o tile de origem e o de destino, para o personagem não ser coberto pelos tiles que está cruzando
+    int getDepthDiagonal() const override;
+
+    // Método para atualizar a posição da câmera
     glm::vec3 updateCameraPosition(float deltaTime, glm::vec3 cameraPos, GLuint width, GLuint height);
 
 private:
-    Tilemap& tilemap;                   // Referncia ao tilemap
+    // Movimento pedido e ainda não iniciado
+    struct BufferedMove {
+        MoveDirection direction;
+        double timestamp;               // Momento do evento de entrada
+        bool repeat;                    // Se veio da repetição da tecla segurada
+    };
+
+    Tilemap& tilemap;                   // Referência ao tilemap
     float tileWidth;                    // Largura do tile
     float tileHeight;                   // Altura do tile
     glm::ivec2 targetTile;              // Tile alvo
-    glm::vec3 targetPosition;           // Posio alvo
-    bool flipedX;                       // Indicador se o sprite est espelhado horizontalmente
-    bool moving;                        // Indicador se o personagem est se movendo
+    glm::ivec2 sourceTile;              // Tile de onde partiu o último movimento
+    glm::vec3 targetPosition;           // Posição alvo
+    bool flipedX;                       // Indicador se o sprite está espelhado horizontalmente
+    bool moving;                        // Indicador se o personagem está se movendo
     float offsetX;                      // Deslocamento X
     float offsetY;                      // Deslocamento Y
+    std::deque<BufferedMove> bufferedMoves;  // Movimentos guardados, no máximo MAX_BUFFERED_MOVES
+    InputLatencyStats latencyStats;     // Latência dos movimentos iniciados desde o último takeLatencyStats()
+
+    // Vira o personagem para a direção e começa o movimento se o tile vizinho for caminhável
+    bool startMove(const BufferedMove& move);
+
+    // Começa o primeiro movimento guardado que levar a um tile caminhável
+    bool startNextBufferedMove();
 
-    // Mtodo para mover o personagem se a posio for caminhvel
+    // Método para mover o personagem se a posição for caminhável
     void moveIfWalkable(int x, int y);
 
-    // Mtodo para atualizar a direo do personagem
+    // Método para atualizar a direção do personagem
     void updateDirection(bool shouldFlipX, float newRotation);
 };
 
@@ -0,0 +1,256 @@
+#include "DecodedImage.h"
+#include <stb_image.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Função que calcula a quantidade de níveis de mipmap até 1x1
+static uint32_t mipLevelCount(int width, int height) {
+    uint32_t count = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++count;
+    }
+    return count;
+}
+
+// Função que calcula os bytes de todos os níveis de mipmap
+static size_t mipChainSize(int width, int height, int channels, uint32_t levelCount) {
+    size_t total = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        total += static_cast<size_t>(width) * height * channels;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return total;
+}
+
+// Função que calcula o hash FNV-1a de 64 bits de um arquivo
+static bool hashFile(const std::string& path, uint64_t& hash) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    hash = 14695981039346656037ull;
+    const unsigned char* data = file.getData();
+    for (size_t i = 0; i < file.getSize(); ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return true;
+}
+
+// Função que grava a nova data da original no cabeçalho de um cache cujo conteúdo continua válido
+// Se não for possível (arquivo aberto por outro processo), o hash é comparado de novo na próxima execução
+static void updateCacheTime(const std::string& path, int64_t sourceTime) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) {
+        return;
+    }
+    file.seekp(offsetof(TextureCacheHeader, sourceTime));
+    file.write(reinterpret_cast<const char*>(&sourceTime), sizeof(sourceTime));
+}
+
+// Construtor da classe DecodedImage
+DecodedImage::DecodedImage() : channels(0), fromCache(false) {
+}
+
+// Função que retorna o caminho do cache de uma imagem
+std::string DecodedImage::cachePath(const std::string& sourcePath) {
+    return sourcePath + ".gbtex";
+}
+
+// Função que carrega a imagem, pelo cache quando possível
+bool DecodedImage::load(const std::string& sourcePath) {
+    levels.clear();
+    storage.clear();
+    cacheFile.close();
+    fromCache = false;
+
+    std::error_code error;
+    uint64_t sourceSize = std::filesystem::file_size(sourcePath, error);
+    if (error) {
+        std::cerr << "Failed to load texture: " << sourcePath << std::endl;
+        return false;
+    }
+    int64_t sourceTime = static_cast<int64_t>(std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count());
+
+    if (loadCache(sourcePath, sourceSize, sourceTime)) {
+        fromCache = true;
+        return true;
+    }
+    return decode(sourcePath, sourceSize, sourceTime);
+}
+
+// Função que mapeia e valida o cache
+bool DecodedImage::loadCache(const std::string& sourcePath, uint64_t sourceSize, int64_t sourceTime) {
+    TextureCacheHeader header;
+    if (!mapCache(sourcePath, sourceSize, header)) {
+        return false;
+    }
+
+    // A data só evita ler a original; com a data diferente o conteúdo é comparado pelo hash
+    // Com o mesmo conteúdo a data nova vai para o cabeçalho, para as próximas execuções não lerem a original
+    // O mapeamento não deixa gravar no arquivo (no Windows nem por outro handle), então é fechado antes e refeito
+    if (header.sourceTime != sourceTime) {
+        uint64_t hash;
+        if (!hashFile(sourcePath, hash) || hash != header.sourceHash) {
+            cacheFile.close();
+            return false;
+        }
+        cacheFile.close();
+        updateCacheTime(cachePath(sourcePath), sourceTime);
+        if (!mapCache(sourcePath, sourceSize, header)) {
+            return false;
+        }
+        if (header.sourceHash != hash) {
+            cacheFile.close();
+            return false;
+        }
+    }
+
+    channels = static_cast<int>(header.channels);
+    setLevels(cacheFile.getData() + sizeof(header), static_cast<int>(header.width), static_cast<int>(header.height), header.levelCount);
+    return true;
+}
+
+// Função que mapeia o cache e confere o cabeçalho
+bool DecodedImage::mapCache(const std::string& sourcePath, uint64_t sourceSize, TextureCacheHeader& header) {
+    if (!cacheFile.open(cachePath(sourcePath))) {
+        return false;
+    }
+
+    bool valid = cacheFile.getSize() >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, cacheFile.getData(), sizeof(header));
+        valid = std::memcmp(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic)) == 0
+            && header.version == TEXTURE_CACHE_VERSION && header.sourceSize == sourceSize
+            && (header.channels == 3 || header.channels == 4)
+            && header.width > 0 && header.height > 0 && header.width <= 65536 && header.height <= 65536
+            && header.levelCount == mipLevelCount(header.width, header.height)
+            && cacheFile.getSize() >= sizeof(header) + mipChainSize(header.width, header.height, header.channels, header.levelCount);
+    }
+    if (!valid) {
+        cacheFile.close();
+    }
+    return valid;
+}
+
+// Função que decodifica a imagem original e grava o cache
+// As mipmaps são a média de blocos 2x2 do nível anterior (com a borda repetida em dimensões ímpares),
+// o mesmo filtro que o glGenerateMipmap usa na prática
+bool DecodedImage::decode(const std::string& sourcePath, uint64_t sourceSize, int64_t sourceTime) {
+    // A inversão é uma variável global do stb_image (esta versão não tem a opção por thread); ela é ligada uma
+    // única vez, antes da primeira decodificação, e as threads do TextureStreamer só a leem
+    static std::once_flag flipOnce;
+    std::call_once(flipOnce, [] { stbi_set_flip_vertically_on_load(true); });
+
+    int width, height, nrChannels;
+    unsigned char* data = stbi_load(sourcePath.c_str(), &width, &height, &nrChannels, 0);
+    if (!data) {
+        std::cerr << "Failed to load texture: " << sourcePath << std::endl;
+        return false;
+    }
+
+    // Imagens em tons de cinza viram RGB ou RGBA, os formatos que o TextureCache envia
+    channels = nrChannels == 3 || nrChannels == 1 ? 3 : 4;
+    uint32_t levelCount = mipLevelCount(width, height);
+    storage.resize(mipChainSize(width, height, channels, levelCount));
+    if (nrChannels == channels) {
+        std::memcpy(storage.data(), data, static_cast<size_t>(width) * height * channels);
+    }
+    else {
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+            const unsigned char* source = data + i * nrChannels;
+            unsigned char* target = storage.data() + i * channels;
+            target[0] = source[0];
+            target[1] = nrChannels >= 3 ? source[1] : source[0];
+            target[2] = nrChannels >= 3 ? source[2] : source[0];
+            if (channels == 4) {
+                target[3] = nrChannels == 2 ? source[1] : (nrChannels == 4 ? source[3] : 255);
+            }
+        }
+    }
+    stbi_image_free(data);
+
+    unsigned char* previous = storage.data();
+    int previousWidth = width, previousHeight = height;
+    for (uint32_t level = 1; level < levelCount; ++level) {
+        unsigned char* current = previous + static_cast<size_t>(previousWidth) * previousHeight * channels;
+        int levelWidth = std::max(1, previousWidth / 2);
+        int levelHeight = std::max(1, previousHeight / 2);
+        for (int y = 0; y < levelHeight; ++y) {
+            int y0 = std::min(y * 2, previousHeight - 1), y1 = std::min(y * 2 + 1, previousHeight - 1);
+            for (int x = 0; x < levelWidth; ++x) {
+                int x0 = std::min(x * 2, previousWidth - 1), x1 = std::min(x * 2 + 1, previousWidth - 1);
+                for (int c = 0; c < channels; ++c) {
+                    int sum = previous[(static_cast<size_t>(y0) * previousWidth + x0) * channels + c]
+                        + previous[(static_cast<size_t>(y0) * previousWidth + x1) * channels + c]
+                        + previous[(static_cast<size_t>(y1) * previousWidth + x0) * channels + c]
+                        + previous[(static_cast<size_t>(y1) * previousWidth + x1) * channels + c];
+                    current[(static_cast<size_t>(y) * levelWidth + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        previous = current;
+        previousWidth = levelWidth;
+        previousHeight = levelHeight;
+    }
+    setLevels(storage.data(), width, height, levelCount);
+
+    // Grava o cache; se não for possível (pasta somente leitura), o jogo segue com a imagem decodificada
+    TextureCacheHeader header = {};
+    std::memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = TEXTURE_CACHE_VERSION;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.channels = static_cast<uint32_t>(channels);
+    header.levelCount = levelCount;
+    if (!hashFile(sourcePath, header.sourceHash)) {
+        return true;
+    }
+
+    // O cache é gravado em um arquivo temporário próprio da thread e depois renomeado: quem abrir o cache ao mesmo
+    // tempo (outra thread do TextureStreamer ou o TextureCache::loadArray) vê o arquivo antigo ou o novo inteiro
+    std::string finalPath = cachePath(sourcePath);
+    std::string tempPath = finalPath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(storage.data()), storage.size());
+        if (!file) {
+            std::cerr << "Failed to write texture cache: " << finalPath << std::endl;
+            file.close();
+            std::remove(tempPath.c_str());
+            return true;
+        }
+    }
+
+    // No Windows a troca falha se o cache antigo estiver mapeado; ele continua valendo e a gravação fica para depois
+    std::error_code error;
+    std::filesystem::rename(tempPath, finalPath, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+    }
+    return true;
+}
+
+// Função que aponta os níveis para os dados em sequência
+void DecodedImage::setLevels(const unsigned char* pixels, int width, int height, uint32_t levelCount) {
+    levels.clear();
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        levels.push_back(ImageLevel{ width, height, pixels });
+        pixels += static_cast<size_t>(width) * height * channels;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef DECODEDIMAGE_H
+#define DECODEDIMAGE_H
+
+#include "MapFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formato do cache de imagens decodificadas (arquivo <imagem>.gbtex ao lado da original), em little-endian:
+//   TextureCacheHeader
+//   levelCount níveis de mipmap em sequência, do maior ao 1x1, com width x height x channels bytes cada,
+//   já invertidos verticalmente como a OpenGL espera (linha 0 = base da imagem)
+const char TEXTURE_CACHE_MAGIC[4] = { 'G', 'B', 'T', 'X' };
+const uint32_t TEXTURE_CACHE_VERSION = 1;
+
+// Cabeçalho do cache de uma imagem
+// O cache vale enquanto o arquivo de origem tiver o mesmo tamanho e a mesma data de modificação; se só a data mudou
+// (uma cópia ou um checkout), o hash do conteúdo decide
+struct TextureCacheHeader {
+    char magic[4];              // TEXTURE_CACHE_MAGIC
+    uint32_t version;           // TEXTURE_CACHE_VERSION
+    uint64_t sourceSize;        // Tamanho do arquivo de origem em bytes
+    int64_t sourceTime;         // Data de modificação do arquivo de origem
+    uint64_t sourceHash;        // Hash FNV-1a de 64 bits do conteúdo do arquivo de origem
+    uint32_t width, height;     // Dimensões do nível 0
+    uint32_t channels;          // Bytes por pixel (3 ou 4)
+    uint32_t levelCount;        // Níveis de mipmap guardados
+};
+
+static_assert(sizeof(TextureCacheHeader) == 48, "TextureCacheHeader must match the on-disk layout");
+
+// Nível de mipmap de uma imagem decodificada
+struct ImageLevel {
+    int width, height;
+    const unsigned char* pixels;    // width x height x channels bytes, linha 0 = base da imagem
+};
+
+// Imagem decodificada com a cadeia de mipmaps completa, sem nenhuma dependência da OpenGL
+// O load() mapeia o cache da imagem quando ele é válido; senão decodifica a original com o stb_image, monta as
+// mipmaps e grava o cache para a próxima execução. Os níveis apontam para o mapeamento ou para a memória do
+// objeto, e valem enquanto ele existir
+class DecodedImage {
+public:
+    DecodedImage();
+
+    // A imagem pode apontar para o próprio mapeamento, por isso não pode ser copiada
+    DecodedImage(const DecodedImage&) = delete;
+    DecodedImage& operator=(const DecodedImage&) = delete;
+
+    // Carrega a imagem pelo cache ou pela original; retorna false se nenhum dos dois puder ser lido
+    bool load(const std::string& sourcePath);
+
+    // Métodos para obter as dimensões, os bytes por pixel e os níveis de mipmap
+    int getWidth() const { return levels.empty() ? 0 : levels[0].width; }
+    int getHeight() const { return levels.empty() ? 0 : levels[0].height; }
+    int getChannels() const { return channels; }
+    size_t getLevelCount() const { return levels.size(); }
+    const ImageLevel& getLevel(size_t level) const { return levels[level]; }
+
+    // Indica se a imagem veio do cache (sem decodificação)
+    bool isFromCache() const { return fromCache; }
+
+    // Retorna o caminho do cache de uma imagem
+    static std::string cachePath(const std::string& sourcePath);
+
+private:
+    // Tenta usar o cache; retorna false se ele não existir ou estiver desatualizado
+    bool loadCache(const std::string& sourcePath, uint64_t sourceSize, int64_t sourceTime);
+
+    // Mapeia o cache e valida o cabeçalho e o tamanho, sem olhar data e hash; fecha o mapeamento se for inválido
+    bool mapCache(const std::string& sourcePath, uint64_t sourceSize, TextureCacheHeader& header);
+
+    // Decodifica a original, monta as mipmaps e grava o cache
+    bool decode(const std::string& sourcePath, uint64_t sourceSize, int64_t sourceTime);
+
+    // Aponta 'levels' para os níveis guardados em sequência a partir de 'pixels'
+    void setLevels(const unsigned char* pixels, int width, int height, uint32_t levelCount);
+
+    MappedFile cacheFile;               // Cache mapeado em memória
+    std::vector<unsigned char> storage; // Níveis decodificados quando a imagem não veio do cache
+    std::vector<ImageLevel> levels;     // Níveis de mipmap, do maior ao 1x1
+    int channels;                       // Bytes por pixel
+    bool fromCache;                     // Se os níveis apontam para o cache
+};
+
+#endif
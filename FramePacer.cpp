@@ -0,0 +1,148 @@
+#include "FramePacer.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+const double FramePacer::DEFAULT_FRAME_RATE = 60.0;
+const double FramePacer::IDLE_TIMEOUT = 0.1;
+const double FramePacer::SPIN_MARGIN = 0.002;
+
+// Construtor da classe FramePacer
+FramePacer::FramePacer(GLFWwindow* window, PacingMode mode, double targetFrameRate)
+    : window(window), mode(mode), frameInterval(1.0 / DEFAULT_FRAME_RATE), nextFrameTime(0.0), timerPeriodRaised(false),
+    idleTime(0.0), idleWindowStart(glfwGetTime()), lastIdleFraction(0.0) {
+    setTargetFrameRate(targetFrameRate);
+    setMode(mode);
+}
+
+// Destrutor: devolve a resolução do timer ao sistema
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    if (timerPeriodRaised) {
+        timeEndPeriod(1);
+    }
+#endif
+}
+
+// Função que troca o modo
+// Só o modo PACING_CAP depende do sleep, então só ele aumenta a resolução do timer do Windows (padrão de 15,6 ms)
+// para 1 ms; nos outros modos o sistema pode voltar ao timer padrão, que gasta menos energia
+void FramePacer::setMode(PacingMode newMode) {
+    mode = newMode;
+    applySwapInterval();
+    nextFrameTime = glfwGetTime();
+
+#ifdef _WIN32
+    bool raise = mode == PACING_CAP;
+    if (raise && !timerPeriodRaised) {
+        timerPeriodRaised = timeBeginPeriod(1) == TIMERR_NOERROR;
+    }
+    else if (!raise && timerPeriodRaised) {
+        timeEndPeriod(1);
+        timerPeriodRaised = false;
+    }
+#endif
+}
+
+// Função que define a taxa alvo do modo PACING_CAP
+void FramePacer::setTargetFrameRate(double framesPerSecond) {
+    frameInterval = 1.0 / std::max(1.0, framesPerSecond);
+}
+
+// Função que retorna o nome de um modo
+const char* FramePacer::getModeName(PacingMode mode) {
+    switch (mode) {
+    case PACING_VSYNC:
+        return "vsync";
+    case PACING_ADAPTIVE_VSYNC:
+        return "adaptive vsync";
+    case PACING_CAP:
+        return "frame cap";
+    case PACING_ON_CHANGE:
+        return "render on change";
+    default:
+        return "unknown";
+    }
+}
+
+// Função chamada no início do frame para processar os eventos
+void FramePacer::pollEvents(PacingMode mode, bool sceneIdle) {
+    if (mode == PACING_ON_CHANGE && sceneIdle) {
+        glfwWaitEventsTimeout(IDLE_TIMEOUT);
+    }
+    else {
+        glfwPollEvents();
+    }
+}
+
+// Função chamada depois da troca de buffers para segurar o próximo frame no modo PACING_CAP
+// O prazo avança um intervalo por frame, assim o erro de um frame é compensado no seguinte; se o frame atrasou
+// mais de um intervalo inteiro, o prazo recomeça do momento atual em vez de acelerar os próximos frames
+void FramePacer::endFrame() {
+    if (mode != PACING_CAP) {
+        addIdleTime(0.0);
+        return;
+    }
+    nextFrameTime += frameInterval;
+    double now = glfwGetTime();
+    if (nextFrameTime < now - frameInterval) {
+        nextFrameTime = now;
+        return;
+    }
+    sleepUntil(nextFrameTime);
+}
+
+// Função que aplica o intervalo de troca de buffers
+// O intervalo -1 (adaptativo) só existe com as extensões de swap tear; sem elas o modo vira vsync comum
+void FramePacer::applySwapInterval() {
+    glfwMakeContextCurrent(window);
+    switch (mode) {
+    case PACING_ADAPTIVE_VSYNC:
+        if (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+            glfwSwapInterval(-1);
+        }
+        else {
+            glfwSwapInterval(1);
+        }
+        break;
+    case PACING_CAP:
+        glfwSwapInterval(0);
+        break;
+    default:
+        glfwSwapInterval(1);
+        break;
+    }
+}
+
+// Função que dorme até o prazo
+// O sleep acorda com até 1 ms de atraso mesmo com o timer em 1 ms, então ele para SPIN_MARGIN antes do prazo e
+// o restante é espera ativa, que cede a thread a cada volta
+void FramePacer::sleepUntil(double deadline) {
+    double start = glfwGetTime();
+    double remaining = deadline - start;
+    if (remaining > SPIN_MARGIN) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(remaining - SPIN_MARGIN));
+    }
+    double slept = glfwGetTime() - start;
+    while (glfwGetTime() < deadline) {
+        std::this_thread::yield();
+    }
+    addIdleTime(slept);
+}
+
+// Função que acumula o tempo ocioso e fecha a medida uma vez por segundo
+void FramePacer::addIdleTime(double seconds) {
+    idleTime += seconds;
+    double now = glfwGetTime();
+    if (now - idleWindowStart >= 1.0) {
+        lastIdleFraction = std::min(1.0, idleTime / (now - idleWindowStart));
+        idleTime = 0.0;
+        idleWindowStart = now;
+    }
+}
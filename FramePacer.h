@@ -0,0 +1,73 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+struct GLFWwindow;
+
+// Modos de ritmo dos frames
+enum PacingMode {
+    PACING_VSYNC = 0,           // Um frame por atualização do monitor (glfwSwapInterval(1))
+    PACING_ADAPTIVE_VSYNC,      // Vsync, mas sem esperar o próximo refresh quando o frame atrasou (swap tear), se o driver suportar
+    PACING_CAP,                 // Vsync desligado e frames limitados à taxa alvo: sleep de alta resolução e espera ativa no final
+    PACING_ON_CHANGE,           // Vsync, e com a cena parada a thread dorme em glfwWaitEventsTimeout até um evento ou o timeout
+    PACING_MODE_COUNT
+};
+
+// Classe que controla o ritmo dos frames
+// Os eventos são lidos na thread principal (pollEvents, que substitui o glfwPollEvents()); o intervalo de troca e a
+// espera do limite de quadros ficam com a thread que tem o contexto OpenGL (setMode e endFrame, depois do
+// glfwSwapBuffers). Sem ela o laço roda o mais rápido possível e ocupa um núcleo e a GPU mesmo com a tela parada
+class FramePacer {
+public:
+    static const double DEFAULT_FRAME_RATE;     // Taxa alvo do modo PACING_CAP (60 quadros por segundo)
+    static const double IDLE_TIMEOUT;           // Maior espera do modo PACING_ON_CHANGE, para as animações continuarem
+    static const double SPIN_MARGIN;            // Final do intervalo feito em espera ativa, mais preciso que o sleep
+
+    // Construtor: aplica o modo na janela, que deve ter o contexto OpenGL atual
+    FramePacer(GLFWwindow* window, PacingMode mode = PACING_VSYNC, double targetFrameRate = DEFAULT_FRAME_RATE);
+
+    // Restaura a resolução padrão do timer do sistema
+    ~FramePacer();
+
+    // O pacer altera o timer do sistema, por isso não pode ser copiado
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Métodos para trocar o modo e a taxa alvo
+    void setMode(PacingMode mode);
+    void setTargetFrameRate(double framesPerSecond);
+
+    // Métodos para obter o modo e o nome de um modo (para o título da janela)
+    PacingMode getMode() const { return mode; }
+    static const char* getModeName(PacingMode mode);
+
+    // Processa os eventos da janela no início do frame; deve ser chamado na thread principal, como exige a GLFW
+    // No modo PACING_ON_CHANGE, com 'sceneIdle' verdadeiro, bloqueia até um evento chegar ou passar o IDLE_TIMEOUT
+    static void pollEvents(PacingMode mode, bool sceneIdle);
+
+    // Espera o fim do intervalo do frame no modo PACING_CAP; deve ser chamado logo depois do glfwSwapBuffers
+    void endFrame();
+
+    // Retorna a fração do último segundo que a thread passou dormindo no limite de quadros
+    double getIdleFraction() const { return lastIdleFraction; }
+
+private:
+    // Aplica o intervalo de troca de buffers do modo atual
+    void applySwapInterval();
+
+    // Dorme até 'deadline' (em segundos do glfwGetTime): sleep até SPIN_MARGIN antes e espera ativa no resto
+    void sleepUntil(double deadline);
+
+    // Soma o tempo dormido e fecha a fração de tempo ocioso a cada segundo
+    void addIdleTime(double seconds);
+
+    GLFWwindow* window;         // Janela cujo contexto recebe o intervalo de troca
+    PacingMode mode;            // Modo atual
+    double frameInterval;       // Duração alvo de um frame no modo PACING_CAP
+    double nextFrameTime;       // Momento em que o próximo frame pode começar no modo PACING_CAP
+    bool timerPeriodRaised;     // Se a resolução do timer do sistema foi aumentada (Windows)
+    double idleTime;            // Tempo dormido desde o início da janela de medida
+    double idleWindowStart;     // Início da janela de medida do tempo ocioso
+    double lastIdleFraction;    // Fração ociosa da última janela de medida
+};
+
+#endif
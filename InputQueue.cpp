@@ -0,0 +1,34 @@
+#include "InputQueue.h"
+#include <algorithm>
+
+const size_t InputQueue::MAX_EVENTS;
+
+// Função que registra a latência de um movimento
+void InputLatencyStats::add(double latency) {
+    ++count;
+    total += latency;
+    max = std::max(max, latency);
+}
+
+// Função que soma as medidas de outro intervalo
+void InputLatencyStats::merge(const InputLatencyStats& other) {
+    count += other.count;
+    total += other.total;
+    max = std::max(max, other.max);
+}
+
+// Função que guarda um evento na fila
+bool InputQueue::push(int key, int action, double time) {
+    if (pending.size() >= MAX_EVENTS) {
+        ++droppedCount;
+        return false;
+    }
+    pending.push_back(InputEvent{ key, action, time });
+    return true;
+}
+
+// Função que entrega os eventos guardados, trocando os vetores para não copiar nem realocar
+void InputQueue::drain(std::vector<InputEvent>& events) {
+    events.clear();
+    events.swap(pending);
+}
@@ -0,0 +1,51 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include <cstddef>
+#include <vector>
+
+// Evento de teclado com o momento em que chegou (glfwGetTime, em segundos)
+struct InputEvent {
+    int key;                    // GLFW_KEY_*
+    int action;                 // GLFW_PRESS, GLFW_REPEAT ou GLFW_RELEASE
+    double time;                // Momento em que o callback recebeu o evento
+};
+
+// Latência entre o evento de entrada e o início do movimento que ele pediu
+struct InputLatencyStats {
+    int count = 0;              // Movimentos iniciados
+    double total = 0.0;         // Soma das latências em segundos
+    double max = 0.0;           // Maior latência em segundos
+
+    // Registra a latência de um movimento
+    void add(double latency);
+
+    // Soma as medidas de outro intervalo
+    void merge(const InputLatencyStats& other);
+
+    // Retorna a latência média em segundos (0 sem movimentos)
+    double average() const { return count > 0 ? total / count : 0.0; }
+};
+
+// Fila de eventos de teclado
+// O callback da GLFW só guarda o evento com o momento de chegada; a simulação esvazia a fila no início de
+// cada passo fixo e decide o que fazer com cada evento, na ordem em que chegaram
+class InputQueue {
+public:
+    static const size_t MAX_EVENTS = 64;    // Eventos guardados entre dois passos; os excedentes são descartados
+
+    // Guarda um evento; retorna false se a fila estiver cheia
+    bool push(int key, int action, double time);
+
+    // Move todos os eventos guardados para 'events' (que é esvaziado antes), do mais antigo ao mais novo
+    void drain(std::vector<InputEvent>& events);
+
+    // Retorna a quantidade de eventos descartados por falta de espaço
+    size_t getDroppedCount() const { return droppedCount; }
+
+private:
+    std::vector<InputEvent> pending;        // Eventos ainda não lidos pela simulação
+    size_t droppedCount = 0;                // Eventos descartados com a fila cheia
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "IsoDepth.h"
+#include <algorithm>
+#include <climits>
+
+// Função que define a ordem de pintura das entidades
+bool EntityDepthOrder::paintsBefore(const Entry& a, const Entry& b) {
+    if (a.diagonal != b.diagonal) {
+        return a.diagonal > b.diagonal;
+    }
+    if (a.x != b.x) {
+        return a.x < b.x;
+    }
+    return a.handle < b.handle;
+}
+
+// Função que acha a posição de uma entidade no vetor ordenado por busca binária
+size_t EntityDepthOrder::find(const Entry& entry) const {
+    return std::lower_bound(order.begin(), order.end(), entry, paintsBefore) - order.begin();
+}
+
+// Função que registra uma entidade, inserindo-a direto na posição ordenada
+int EntityDepthOrder::add(int diagonal, int x) {
+    int handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+    else {
+        handle = static_cast<int>(placed.size());
+        placed.push_back(Entry());
+        target.push_back(Entry());
+        active.push_back(0);
+        marked.push_back(0);
+    }
+
+    Entry entry = { diagonal, x, handle };
+    placed[handle] = target[handle] = entry;
+    active[handle] = 1;
+    order.insert(order.begin() + find(entry), entry);
+    return handle;
+}
+
+// Função que remove uma entidade
+void EntityDepthOrder::remove(int handle) {
+    if (handle < 0 || handle >= static_cast<int>(active.size()) || !active[handle]) {
+        return;
+    }
+    order.erase(order.begin() + find(placed[handle]));
+    active[handle] = 0;
+    freeHandles.push_back(handle);
+}
+
+// Função que guarda a nova posição de uma entidade para o próximo update()
+void EntityDepthOrder::move(int handle, int diagonal, int x) {
+    if (handle < 0 || handle >= static_cast<int>(active.size()) || !active[handle]) {
+        return;
+    }
+    target[handle].diagonal = diagonal;
+    target[handle].x = x;
+    bool changed = diagonal != placed[handle].diagonal || x != placed[handle].x;
+    if (changed && !marked[handle]) {
+        marked[handle] = 1;
+        moved.push_back(handle);
+    }
+}
+
+// Função que reposiciona somente as entidades que se moveram
+// Cada uma sai da posição antiga e entra na nova com um std::rotate do trecho entre as duas, que é curto
+// porque uma entidade anda no máximo poucos tiles por frame
+void EntityDepthOrder::update() {
+    lastUpdateCount = 0;
+    for (int handle : moved) {
+        marked[handle] = 0;
+        if (!active[handle]) {
+            continue;
+        }
+        Entry next = target[handle];
+        if (next.diagonal == placed[handle].diagonal && next.x == placed[handle].x) {
+            continue;
+        }
+
+        size_t from = find(placed[handle]);
+        size_t to = find(next);
+        if (to > from) {
+            // A posição 'to' conta a própria entidade, que sai da frente dela
+            std::rotate(order.begin() + from, order.begin() + from + 1, order.begin() + to);
+            order[to - 1] = next;
+        }
+        else {
+            std::rotate(order.begin() + to, order.begin() + from, order.begin() + from + 1);
+            order[to] = next;
+        }
+        placed[handle] = next;
+        ++lastUpdateCount;
+    }
+    moved.clear();
+}
+
+// Função que lista as diagonais ocupadas dentro de uma faixa
+void EntityDepthOrder::diagonalsInRange(int dMin, int dMax, std::vector<int>& diagonals) const {
+    diagonals.clear();
+    Entry first = { dMax, INT_MIN, INT_MIN };
+    for (size_t i = find(first); i < order.size() && order[i].diagonal >= dMin; ++i) {
+        if (diagonals.empty() || diagonals.back() != order[i].diagonal) {
+            diagonals.push_back(order[i].diagonal);
+        }
+    }
+}
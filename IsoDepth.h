@@ -0,0 +1,84 @@
+#ifndef ISODEPTH_H
+#define ISODEPTH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Profundidade isométrica compartilhada pelos tiles e pelas entidades
+// A ordem de pintura é a dos tiles: diagonal d = x + y decrescente (do fundo para a frente). Cada diagonal tem
+// ISO_SLOTS_PER_DIAGONAL posições: os tiles da diagonal desenham na posição ISO_SLOT_TILES e as entidades
+// que estão nela logo depois, na posição ISO_SLOT_ENTITIES, antes dos tiles da diagonal seguinte
+const int ISO_MAX_DIAGONAL = 2 * 65535;         // Maior diagonal de um mapa 65536x65536 (limite do TileInstance)
+const uint32_t ISO_SLOTS_PER_DIAGONAL = 4;
+
+// Posições de desenho dentro de uma diagonal
+enum IsoDepthSlot : uint32_t {
+    ISO_SLOT_TILES = 0,         // Tiles da diagonal
+    ISO_SLOT_ENTITIES = 1       // Entidades que estão na diagonal
+};
+
+// Profundidade de pintura da diagonal: menor desenha antes (vai no campo de profundidade da chave da RenderQueue)
+inline uint32_t isoPainterDepth(int diagonal, uint32_t slot) {
+    int clamped = diagonal < 0 ? 0 : (diagonal > ISO_MAX_DIAGONAL ? ISO_MAX_DIAGONAL : diagonal);
+    return static_cast<uint32_t>(ISO_MAX_DIAGONAL - clamped) * ISO_SLOTS_PER_DIAGONAL + slot;
+}
+
+// Converte a profundidade de pintura em z do mundo para o modo com depth buffer:
+// -1 é o fundo e valores maiores ficam na frente (a projeção ortográfica vai de -1 a 1)
+// O shader dos tiles (tile.vs) repete esta conta
+inline float isoDepthZ(uint32_t painterDepth) {
+    const float levels = static_cast<float>(ISO_SLOTS_PER_DIAGONAL * (ISO_MAX_DIAGONAL + 1) + 1);
+    return -1.0f + 2.0f * (static_cast<float>(painterDepth) + 1.0f) / levels;
+}
+
+// Classe que mantém as entidades do mundo em ordem de pintura (diagonal decrescente, x crescente)
+// Só as entidades que mudaram de tile são reposicionadas no update(), por inserção no vetor já ordenado,
+// sem reordenar as demais. O Tilemap usa as diagonais ocupadas para dividir o desenho dos tiles em faixas
+// e intercalar as entidades entre elas
+class EntityDepthOrder {
+public:
+    // Registra uma entidade no tile (x, diagonal - x) e retorna o identificador dela
+    int add(int diagonal, int x);
+
+    // Remove a entidade
+    void remove(int handle);
+
+    // Informa a posição atual da entidade; só marca a entidade para o update() se ela mudou de lugar
+    void move(int handle, int diagonal, int x);
+
+    // Reposiciona as entidades marcadas
+    void update();
+
+    // Preenche 'diagonals' com as diagonais ocupadas entre dMin e dMax, em ordem de pintura, sem repetições
+    void diagonalsInRange(int dMin, int dMax, std::vector<int>& diagonals) const;
+
+    // Métodos para obter a quantidade de entidades e de entidades reposicionadas no último update()
+    size_t size() const { return order.size(); }
+    size_t getLastUpdateCount() const { return lastUpdateCount; }
+
+private:
+    // Posição de uma entidade na ordem de pintura
+    struct Entry {
+        int diagonal;
+        int x;
+        int handle;             // Desempata entidades no mesmo tile
+    };
+
+    // Ordem de pintura: diagonal decrescente, depois x crescente
+    static bool paintsBefore(const Entry& a, const Entry& b);
+
+    // Posição de 'entry' no vetor ordenado
+    size_t find(const Entry& entry) const;
+
+    std::vector<Entry> order;           // Entidades em ordem de pintura
+    std::vector<Entry> placed;          // Posição em 'order' de cada identificador
+    std::vector<Entry> target;          // Posição informada no último move() de cada identificador
+    std::vector<char> active;           // Se o identificador está em uso
+    std::vector<char> marked;           // Se o identificador está em 'moved'
+    std::vector<int> moved;             // Identificadores a reposicionar no próximo update()
+    std::vector<int> freeHandles;       // Identificadores liberados para reuso
+    size_t lastUpdateCount = 0;         // Entidades reposicionadas no último update()
+};
+
+#endif
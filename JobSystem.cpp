@@ -0,0 +1,238 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+
+// Função que soma as medidas de outra execução
+void JobRunStats::merge(const JobRunStats& other) {
+    wallTime += other.wallTime;
+    if (workers.size() < other.workers.size()) {
+        workers.resize(other.workers.size());
+    }
+    for (size_t i = 0; i < other.workers.size(); ++i) {
+        workers[i].busyTime += other.workers[i].busyTime;
+        workers[i].taskCount += other.workers[i].taskCount;
+        workers[i].stolenCount += other.workers[i].stolenCount;
+    }
+}
+
+// Função que retorna a fração do tempo em que uma thread executou tarefas
+double JobRunStats::utilization(size_t worker) const {
+    if (worker >= workers.size() || wallTime <= 0.0) {
+        return 0.0;
+    }
+    return std::min(1.0, workers[worker].busyTime / wallTime);
+}
+
+// Função que adiciona um trabalho simples: um parallel for de um item só
+JobGraph::JobId JobGraph::add(const char* name, std::function<void()> work) {
+    return addParallelFor(name, 1, 1, [work](size_t, size_t) { work(); });
+}
+
+// Função que adiciona um parallel for
+JobGraph::JobId JobGraph::addParallelFor(const char* name, size_t count, size_t grain, std::function<void(size_t begin, size_t end)> work) {
+    nodes.emplace_back();
+    Node& node = nodes.back();
+    node.name = name;
+    node.work = work;
+    node.count = count;
+    node.grain = std::max<size_t>(1, grain);
+    return static_cast<JobId>(nodes.size() - 1);
+}
+
+// Função que muda a quantidade de itens de um parallel for
+void JobGraph::setCount(JobId job, size_t count) {
+    nodes[job].count = count;
+}
+
+// Função que registra uma dependência; o grafo não pode ter ciclos
+void JobGraph::addDependency(JobId job, JobId dependsOn) {
+    nodes[dependsOn].successors.push_back(job);
+    ++nodes[job].dependencyCount;
+}
+
+// Construtor da classe JobSystem
+JobSystem::JobSystem(int workerCount)
+    : graph(nullptr), queuedTasks(0), remainingNodes(0), stopping(false) {
+    int threadCount = std::max(0, workerCount) + 1;
+    for (int i = 0; i < threadCount; ++i) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    for (int i = 1; i < threadCount; ++i) {
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+    lastRunStats.workers.resize(threadCount);
+}
+
+// Destrutor: acorda e encerra as threads de trabalho
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (size_t i = 1; i < workers.size(); ++i) {
+        workers[i]->thread.join();
+    }
+}
+
+// Função que retorna a quantidade padrão de threads de trabalho
+int JobSystem::defaultWorkerCount() {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, cores - 2);
+}
+
+// Função que executa um grafo
+// Os contadores são reiniciados, os trabalhos sem dependências entram na fila da thread 0 e ela executa e rouba
+// tarefas como as outras até o último trabalho terminar
+void JobSystem::run(JobGraph& jobGraph) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::unique_ptr<Worker>& worker : workers) {
+        worker->stats = JobWorkerStats();
+    }
+
+    graph = &jobGraph;
+    for (JobGraph::Node& node : jobGraph.nodes) {
+        node.pendingDependencies.store(node.dependencyCount, std::memory_order_relaxed);
+        node.pendingItems.store(node.count, std::memory_order_relaxed);
+    }
+    remainingNodes.store(jobGraph.nodes.size(), std::memory_order_release);
+
+    for (JobGraph::Node& node : jobGraph.nodes) {
+        if (node.dependencyCount == 0) {
+            schedule(0, node);
+        }
+    }
+
+    while (remainingNodes.load(std::memory_order_acquire) > 0) {
+        if (!runOneTask(0)) {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [this] {
+                return remainingNodes.load(std::memory_order_acquire) == 0 || queuedTasks.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+    graph = nullptr;
+
+    lastRunStats.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        lastRunStats.workers[i] = workers[i]->stats;
+    }
+}
+
+// Função que executa um parallel for avulso
+void JobSystem::parallelFor(size_t count, size_t grain, std::function<void(size_t begin, size_t end)> work) {
+    JobGraph single;
+    single.addParallelFor("parallelFor", count, grain, work);
+    run(single);
+}
+
+// Função executada pelas threads de trabalho: executa tarefas enquanto houver e dorme quando as filas esvaziam
+void JobSystem::workerLoop(int index) {
+    while (true) {
+        if (runOneTask(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.wait(lock, [this] { return stopping || queuedTasks.load(std::memory_order_acquire) > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+// Função que procura uma tarefa e a executa
+// A própria fila é lida pelo fim (a tarefa mais recente, com os dados ainda no cache); as outras são roubadas
+// pelo começo, a partir da thread seguinte, para as threads não disputarem sempre a mesma vítima
+bool JobSystem::runOneTask(int index) {
+    Task task;
+    bool found = false;
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    for (size_t offset = 1; !found && offset < workers.size(); ++offset) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            found = true;
+            ++workers[index]->stats.stolenCount;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+    queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    execute(index, task);
+    return true;
+}
+
+// Função que executa uma tarefa
+// As medidas são gravadas antes da baixa nos itens: quem vê o grafo terminado também vê as medidas
+void JobSystem::execute(int index, Task task) {
+    JobGraph::Node& node = *task.node;
+    while (task.end - task.begin > node.grain) {
+        size_t middle = task.begin + (task.end - task.begin) / 2;
+        push(index, Task{ &node, middle, task.end });
+        task.end = middle;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    node.work(task.begin, task.end);
+    JobWorkerStats& stats = workers[index]->stats;
+    stats.busyTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ++stats.taskCount;
+
+    size_t items = task.end - task.begin;
+    if (node.pendingItems.fetch_sub(items, std::memory_order_acq_rel) == items) {
+        finishNode(index, node);
+    }
+}
+
+// Função que coloca uma tarefa na fila de uma thread
+void JobSystem::push(int index, const Task& task) {
+    {
+        Worker& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(task);
+    }
+    queuedTasks.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wakeCondition.notify_one();
+}
+
+// Função que começa um trabalho; um parallel for vazio termina na hora
+void JobSystem::schedule(int index, JobGraph::Node& node) {
+    if (node.count == 0) {
+        finishNode(index, node);
+        return;
+    }
+    push(index, Task{ &node, 0, node.count });
+}
+
+// Função que encerra um trabalho
+// Os sucessores são liberados antes da baixa em remainingNodes, assim o run() nunca vê o grafo vazio antes da hora
+void JobSystem::finishNode(int index, JobGraph::Node& node) {
+    for (JobGraph::JobId successor : node.successors) {
+        JobGraph::Node& next = graph->nodes[successor];
+        if (next.pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(index, next);
+        }
+    }
+    if (remainingNodes.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_all();
+    }
+}
@@ -0,0 +1,150 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Medidas de uma thread em uma ou mais execuções do JobSystem
+struct JobWorkerStats {
+    double busyTime = 0.0;      // Tempo executando tarefas em segundos
+    int taskCount = 0;          // Tarefas executadas
+    int stolenCount = 0;        // Tarefas roubadas da fila de outra thread
+};
+
+// Medidas de uma ou mais execuções do JobSystem; a thread 0 é a que chamou o run()
+struct JobRunStats {
+    double wallTime = 0.0;                  // Duração das execuções em segundos
+    std::vector<JobWorkerStats> workers;    // Medidas de cada thread
+
+    // Soma as medidas de outra execução
+    void merge(const JobRunStats& other);
+
+    // Retorna a fração do tempo das execuções em que a thread 'worker' executou tarefas (0 a 1)
+    double utilization(size_t worker) const;
+};
+
+// Grafo de trabalhos de uma fase da atualização
+// Cada trabalho é uma função simples ou um parallel for sobre [0, count), dividido em faixas de pelo menos 'grain'
+// itens. As dependências viram contadores: um trabalho só começa quando todos os trabalhos de que ele depende
+// terminaram. O grafo é montado uma vez e executado quantas vezes for preciso; as funções devem capturar por
+// referência os dados que mudam entre as execuções
+class JobGraph {
+public:
+    typedef int JobId;
+
+    // Adiciona um trabalho que roda uma vez
+    JobId add(const char* name, std::function<void()> work);
+
+    // Adiciona um parallel for: 'work' recebe faixas [begin, end) de [0, count) com pelo menos 'grain' itens
+    JobId addParallelFor(const char* name, size_t count, size_t grain, std::function<void(size_t begin, size_t end)> work);
+
+    // Muda a quantidade de itens de um parallel for antes da próxima execução
+    void setCount(JobId job, size_t count);
+
+    // Faz 'job' esperar o fim de 'dependsOn'
+    void addDependency(JobId job, JobId dependsOn);
+
+    // Retorna a quantidade de trabalhos
+    size_t size() const { return nodes.size(); }
+
+private:
+    friend class JobSystem;
+
+    // Trabalho do grafo; os contadores são reiniciados a cada execução
+    struct Node {
+        const char* name;
+        std::function<void(size_t, size_t)> work;
+        size_t count;                               // Itens do parallel for (1 nos trabalhos simples)
+        size_t grain;                               // Menor faixa de uma tarefa
+        std::vector<JobId> successors;              // Trabalhos que dependem deste
+        int dependencyCount = 0;                    // Trabalhos de que este depende
+        std::atomic<int> pendingDependencies{ 0 };  // Dependências ainda não terminadas na execução atual
+        std::atomic<size_t> pendingItems{ 0 };      // Itens ainda não executados na execução atual
+    };
+
+    std::deque<Node> nodes;                         // Deque: os nós têm atômicos e não podem ser movidos
+};
+
+// Sistema de trabalhos com roubo de tarefas (work stealing)
+// Cada thread tem a própria fila de tarefas: ela empilha e tira do fim, e as threads sem trabalho roubam do
+// começo da fila das outras, onde ficam as faixas maiores. Um parallel for começa como uma única tarefa que vai
+// sendo dividida ao meio; a metade de cima volta para a fila e pode ser roubada, então as faixas se espalham
+// pelas threads sem dividir tudo de antemão. A thread que chama o run() trabalha junto (thread 0)
+class JobSystem {
+public:
+    // Construtor: inicia 'workerCount' threads além da que chama o run()
+    explicit JobSystem(int workerCount = defaultWorkerCount());
+
+    // Para as threads de trabalho
+    ~JobSystem();
+
+    // As threads guardam 'this', por isso o objeto não pode ser copiado
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Executa o grafo inteiro e retorna quando todos os trabalhos terminarem; não pode ser chamado de dentro de um trabalho
+    void run(JobGraph& graph);
+
+    // Executa um parallel for avulso sobre [0, count)
+    void parallelFor(size_t count, size_t grain, std::function<void(size_t begin, size_t end)> work);
+
+    // Retorna as medidas da última execução
+    const JobRunStats& getLastRunStats() const { return lastRunStats; }
+
+    // Retorna a quantidade de threads que executam tarefas, contando a que chama o run()
+    int getThreadCount() const { return static_cast<int>(workers.size()); }
+
+    // Threads de trabalho padrão: os núcleos menos a thread principal e a de desenho, no mínimo uma
+    static int defaultWorkerCount();
+
+private:
+    // Faixa de um trabalho do grafo
+    struct Task {
+        JobGraph::Node* node;
+        size_t begin, end;
+    };
+
+    // Fila e medidas de uma thread
+    struct Worker {
+        std::mutex mutex;               // Protege tasks
+        std::deque<Task> tasks;         // Tarefas da thread: a dona usa o fim, as outras roubam do começo
+        JobWorkerStats stats;           // Medidas da execução atual, escritas só pela dona
+        std::thread thread;             // Thread de trabalho (vazia na thread 0)
+    };
+
+    // Laço das threads de trabalho
+    void workerLoop(int index);
+
+    // Tira uma tarefa da própria fila ou rouba de outra thread e a executa; retorna false se não achou nenhuma
+    bool runOneTask(int index);
+
+    // Executa uma tarefa, devolvendo para a fila a metade de cima enquanto a faixa for maior que o grain
+    void execute(int index, Task task);
+
+    // Coloca uma tarefa na fila da thread e acorda uma thread parada
+    void push(int index, const Task& task);
+
+    // Começa um trabalho cujas dependências terminaram
+    void schedule(int index, JobGraph::Node& node);
+
+    // Marca o fim de um trabalho e começa os que dependiam só dele
+    void finishNode(int index, JobGraph::Node& node);
+
+    JobGraph* graph;                                // Grafo em execução
+    std::vector<std::unique_ptr<Worker>> workers;   // Uma por thread; a 0 é a que chama o run()
+    std::atomic<int> queuedTasks;                   // Tarefas nas filas de todas as threads
+    std::atomic<size_t> remainingNodes;             // Trabalhos do grafo ainda não terminados
+    bool stopping;                                  // Pede o fim das threads de trabalho (protegido por wakeMutex)
+    std::mutex wakeMutex;                           // Só serve às esperas; as filas têm os próprios mutexes
+    std::condition_variable wakeCondition;          // Acorda as threads quando chega tarefa ou o grafo termina
+    JobRunStats lastRunStats;                       // Medidas da última execução
+};
+
+#endif
@@ -0,0 +1,452 @@
+#include "MapFile.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Construtor da classe MappedFile
+MappedFile::MappedFile()
+    : data(nullptr), size(0)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{
+}
+
+// Destrutor: desfaz o mapeamento
+MappedFile::~MappedFile() {
+    close();
+}
+
+// Função que mapeia o arquivo inteiro em memória
+// O mapeamento é privado (cópia na escrita), assim a grid pode ser editada sem alterar o arquivo
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<unsigned char*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        ::close(file);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    ::close(file);  // O mapeamento continua válido sem o descritor
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<unsigned char*>(view);
+    size = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+// Função que desfaz o mapeamento
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (data != nullptr) {
+        munmap(data, size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+// Função que identifica um mapa binário pela extensão
+bool isBinaryMapPath(const std::string& path) {
+    const std::string extension = ".gbmap";
+    return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+// Limites dos mapas, iguais nos formatos texto e binário
+static const int MAX_TILE_INDEX = 0xffff;   // Limite do TileGrid::TileId
+static const int MAX_MAP_SIDE = 1 << 16;    // Limite de cada dimensão do mapa
+
+// Função que verifica se a grid cabe nos índices int usados pelo Tilemap (y * largura + x)
+static bool mapAreaFits(long long width, long long height) {
+    return width * height <= INT_MAX;
+}
+
+// Função que retorna as propriedades de um índice de textura, aumentando a tabela se necessário
+static TileProperties& propertiesFor(MapDescription& map, int textureIndex) {
+    if (textureIndex >= static_cast<int>(map.properties.size())) {
+        map.properties.resize(textureIndex + 1);
+    }
+    return map.properties[textureIndex];
+}
+
+// Leitor do formato texto que percorre o arquivo inteiro na memória sem criar strings ou streams
+// Guarda a linha e o início da linha atual para informar linha e coluna nos erros
+class TextMapScanner {
+public:
+    TextMapScanner(const char* begin, const char* end, const std::string& name)
+        : cursor(begin), end(end), lineStart(begin), line(1), name(name) {
+    }
+
+    // Pula espaços, tabs e o '\r' de arquivos com final de linha do Windows, sem passar do fim da linha
+    void skipBlanks() {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+            ++cursor;
+        }
+    }
+
+    // Indica se não há mais nada na linha atual
+    bool atLineEnd() {
+        skipBlanks();
+        return cursor == end || *cursor == '\n';
+    }
+
+    // Indica se não há mais nada no arquivo além de linhas em branco
+    bool atEnd() {
+        while (atLineEnd() && cursor < end) {
+            nextLine();
+        }
+        return cursor == end;
+    }
+
+    // Avança para o início da próxima linha
+    void nextLine() {
+        cursor = std::find(cursor, end, '\n');
+        cursor += cursor < end ? 1 : 0;
+        lineStart = cursor;
+        ++line;
+    }
+
+    // Lê o resto da linha, sem os espaços das pontas, e avança para a próxima
+    bool readLine(std::string& value, const char* what) {
+        skipBlanks();
+        const char* first = cursor;
+        const char* last = std::find(cursor, end, '\n');
+        cursor = last;
+        while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) {
+            --last;
+        }
+        if (first == last) {
+            return fail(std::string("expected ") + what);
+        }
+        value.assign(first, last);
+        nextLine();
+        return true;
+    }
+
+    // Verifica se a linha atual começa com a palavra informada, seguida de espaço
+    bool startsWithWord(const char* word) {
+        skipBlanks();
+        size_t length = std::strlen(word);
+        return static_cast<size_t>(end - cursor) > length && std::memcmp(cursor, word, length) == 0
+            && (cursor[length] == ' ' || cursor[length] == '\t');
+    }
+
+    // Pula a palavra que startsWithWord confirmou
+    void skipWord(const char* word) {
+        cursor += std::strlen(word);
+    }
+
+    // Lê um inteiro entre minValue e maxValue; o número precisa terminar em espaço ou no fim da linha
+    bool readInt(int& value, int minValue, int maxValue, const char* what) {
+        skipBlanks();
+        if (cursor == end || *cursor == '\n') {
+            return fail(std::string("expected ") + what + (cursor == end ? ", found end of file" : ", found end of line"));
+        }
+        std::from_chars_result result = std::from_chars(cursor, end, value);
+        if (result.ec == std::errc::invalid_argument) {
+            return fail(std::string("expected ") + what + ", found '" + *cursor + "'");
+        }
+        if (result.ec == std::errc::result_out_of_range || value < minValue || value > maxValue) {
+            return fail(std::string(what) + " " + std::string(cursor, result.ptr) + " is outside ["
+                + std::to_string(minValue) + ", " + std::to_string(maxValue) + "]");
+        }
+        if (result.ptr < end && *result.ptr != ' ' && *result.ptr != '\t' && *result.ptr != '\r' && *result.ptr != '\n') {
+            cursor = result.ptr;
+            return fail(std::string("unexpected character '") + *cursor + "' after " + what);
+        }
+        cursor = result.ptr;
+        return true;
+    }
+
+    // Exige que a linha atual tenha terminado e avança para a próxima
+    bool endLine(const char* context) {
+        if (!atLineEnd()) {
+            return fail(std::string("unexpected text after ") + context);
+        }
+        nextLine();
+        return true;
+    }
+
+    // Informa o erro com arquivo, linha e coluna; sempre retorna false
+    bool fail(const std::string& message) const {
+        std::cerr << name << ":" << line << ":" << (cursor - lineStart + 1) << ": " << message << std::endl;
+        return false;
+    }
+
+private:
+    const char* cursor;         // Próximo caractere a ler
+    const char* end;            // Fim do arquivo
+    const char* lineStart;      // Início da linha atual, usado para calcular a coluna
+    int line;                   // Linha atual (começa em 1)
+    const std::string& name;    // Nome do arquivo nas mensagens de erro
+};
+
+// Função que lê o mapa no formato texto
+// O arquivo é mapeado em memória e lido uma única vez; os números da grid vão direto para o TileGrid
+bool loadTextMap(const std::string& path, MapDescription& map) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to open configuration file: " << path << std::endl;
+        return false;
+    }
+    const char* text = reinterpret_cast<const char*>(file.getData());
+    return parseTextMap(text, text + file.getSize(), path, map);
+}
+
+// Função que interpreta o conteúdo de um mapa no formato texto
+bool parseTextMap(const char* begin, const char* end, const std::string& name, MapDescription& map) {
+    TextMapScanner scanner(begin, end, name);
+
+    // Lê o caminho da textura
+    if (!scanner.readLine(map.texturePath, "texture path")) {
+        return false;
+    }
+
+    // Lê o a quantidade de texturas diferentes
+    if (!scanner.readInt(map.tileCount, 0, MAX_TILE_INDEX + 1, "tile count") || !scanner.endLine("tile count")) {
+        return false;
+    }
+
+    // Lê o valor da grid da spritesheet da textura
+    if (!scanner.readInt(map.tileColumns, 1, MAX_TILE_INDEX, "spritesheet columns")
+        || !scanner.readInt(map.tileRows, 1, MAX_TILE_INDEX, "spritesheet rows")
+        || !scanner.endLine("spritesheet size")) {
+        return false;
+    }
+
+    // Lê o valor da grid do tilemap
+    int mapWidth = 0, mapHeight = 0;
+    if (!scanner.readInt(mapWidth, 1, MAX_MAP_SIDE, "map width")
+        || !scanner.readInt(mapHeight, 1, MAX_MAP_SIDE, "map height")
+        || !scanner.endLine("map size")) {
+        return false;
+    }
+    if (!mapAreaFits(mapWidth, mapHeight)) {
+        return scanner.fail("map size " + std::to_string(mapWidth) + "x" + std::to_string(mapHeight) + " has more than " + std::to_string(INT_MAX) + " tiles");
+    }
+
+    // Lê o valor das texturas que não podem ser caminhadas (valores negativos são ignorados)
+    map.properties.assign(map.tileCount, TileProperties());
+    while (!scanner.atLineEnd()) {
+        int textureNumber;
+        if (!scanner.readInt(textureNumber, -1, MAX_TILE_INDEX, "non-walkable tile index")) {
+            return false;
+        }
+        if (textureNumber >= 0) {
+            propertiesFor(map, textureNumber).walkable = false;
+        }
+    }
+    scanner.nextLine();
+
+    // Lê as linhas opcionais de propriedades: "prop <textura> <caminhável 0/1> <custo> <flags de gatilho>"
+    while (scanner.startsWithWord("prop")) {
+        scanner.skipWord("prop");
+        int textureIndex, walkable, moveCost, triggerFlags;
+        if (!scanner.readInt(textureIndex, 0, MAX_TILE_INDEX, "property tile index")
+            || !scanner.readInt(walkable, 0, 1, "walkable flag")
+            || !scanner.readInt(moveCost, 0, 255, "move cost")
+            || !scanner.readInt(triggerFlags, 0, 255, "trigger flags")
+            || !scanner.endLine("tile property")) {
+            return false;
+        }
+        TileProperties& properties = propertiesFor(map, textureIndex);
+        properties.walkable = walkable != 0;
+        properties.moveCost = static_cast<uint8_t>(moveCost);
+        properties.triggerFlags = static_cast<uint8_t>(triggerFlags);
+    }
+
+    // Lê a grid direto para o buffer do TileGrid, uma linha do arquivo por linha do mapa
+    map.grid.resize(mapWidth, mapHeight);
+    for (int y = 0; y < mapHeight; ++y) {
+        TileGrid::TileId* row = map.grid.row(y);
+        for (int x = 0; x < mapWidth; ++x) {
+            int tileIndex;
+            if (!scanner.readInt(tileIndex, 0, MAX_TILE_INDEX, "tile index")) {
+                return false;
+            }
+            row[x] = static_cast<TileGrid::TileId>(tileIndex);
+        }
+        if (!scanner.endLine("the last tile of the row")) {
+            return false;
+        }
+    }
+
+    if (!scanner.atEnd()) {
+        return scanner.fail("unexpected data after the last map row (the map is " + std::to_string(mapWidth) + "x" + std::to_string(mapHeight) + ")");
+    }
+    return true;
+}
+
+// Função que mapeia um mapa binário
+// Só o cabeçalho, o caminho e a tabela de propriedades são copiados; a grid é usada direto do mapeamento
+bool loadBinaryMap(const std::string& path, MappedFile& file, MapDescription& map) {
+    if (!file.open(path)) {
+        std::cerr << "Failed to open binary map file: " << path << std::endl;
+        return false;
+    }
+
+    const unsigned char* data = file.getData();
+    size_t size = file.getSize();
+
+    MapFileHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "Binary map file is truncated: " << path << std::endl;
+        file.close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MAP_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "Not a binary map file: " << path << std::endl;
+        file.close();
+        return false;
+    }
+    if (header.version != MAP_FILE_VERSION) {
+        std::cerr << "Unsupported binary map version " << header.version << " (expected " << MAP_FILE_VERSION << "): " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    // Valida que todas as seções cabem no arquivo antes de tocar nelas
+    unsigned long long tableEnd = sizeof(header) + static_cast<unsigned long long>(header.texturePathLength)
+        + static_cast<unsigned long long>(header.propertyCount) * sizeof(MapFileProperty);
+    unsigned long long gridEnd = header.gridOffset + static_cast<unsigned long long>(header.width) * header.height * sizeof(TileGrid::TileId);
+    if (header.gridOffset < tableEnd || header.gridOffset % sizeof(TileGrid::TileId) != 0 || gridEnd > size) {
+        std::cerr << "Binary map file is corrupt: " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    // Aplica os mesmos limites do formato texto: um arquivo gravado à mão ou corrompido não passa do carregamento
+    if (header.tileCount > static_cast<uint32_t>(MAX_TILE_INDEX) + 1
+        || header.tileColumns < 1 || header.tileColumns > static_cast<uint32_t>(MAX_TILE_INDEX)
+        || header.tileRows < 1 || header.tileRows > static_cast<uint32_t>(MAX_TILE_INDEX)
+        || header.width < 1 || header.width > static_cast<uint32_t>(MAX_MAP_SIDE)
+        || header.height < 1 || header.height > static_cast<uint32_t>(MAX_MAP_SIDE)
+        || !mapAreaFits(header.width, header.height)) {
+        std::cerr << "Binary map file has invalid dimensions (tiles " << header.tileCount << ", spritesheet "
+            << header.tileColumns << "x" << header.tileRows << ", map " << header.width << "x" << header.height << "): " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    const unsigned char* cursor = data + sizeof(header);
+    map.texturePath.assign(reinterpret_cast<const char*>(cursor), header.texturePathLength);
+    cursor += header.texturePathLength;
+
+    map.tileCount = static_cast<int>(header.tileCount);
+    map.tileColumns = static_cast<int>(header.tileColumns);
+    map.tileRows = static_cast<int>(header.tileRows);
+
+    map.properties.resize(header.propertyCount);
+    for (uint32_t i = 0; i < header.propertyCount; ++i, cursor += sizeof(MapFileProperty)) {
+        MapFileProperty entry;
+        std::memcpy(&entry, cursor, sizeof(entry));
+        map.properties[i].walkable = entry.walkable != 0;
+        map.properties[i].moveCost = entry.moveCost;
+        map.properties[i].triggerFlags = entry.triggerFlags;
+    }
+
+    map.grid.attach(static_cast<int>(header.width), static_cast<int>(header.height),
+        reinterpret_cast<TileGrid::TileId*>(file.getData() + header.gridOffset));
+    return true;
+}
+
+// Função que grava o mapa no formato binário
+bool writeBinaryMap(const std::string& path, const MapDescription& map) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create binary map file: " << path << std::endl;
+        return false;
+    }
+
+    MapFileHeader header;
+    std::memcpy(header.magic, MAP_FILE_MAGIC, sizeof(header.magic));
+    header.version = MAP_FILE_VERSION;
+    header.width = static_cast<uint32_t>(map.grid.getWidth());
+    header.height = static_cast<uint32_t>(map.grid.getHeight());
+    header.tileCount = static_cast<uint32_t>(map.tileCount);
+    header.tileColumns = static_cast<uint32_t>(map.tileColumns);
+    header.tileRows = static_cast<uint32_t>(map.tileRows);
+    header.propertyCount = static_cast<uint32_t>(map.properties.size());
+    header.texturePathLength = static_cast<uint32_t>(map.texturePath.size());
+
+    uint32_t tableEnd = static_cast<uint32_t>(sizeof(header) + map.texturePath.size() + map.properties.size() * sizeof(MapFileProperty));
+    header.gridOffset = (tableEnd + MAP_FILE_GRID_ALIGNMENT - 1) / MAP_FILE_GRID_ALIGNMENT * MAP_FILE_GRID_ALIGNMENT;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(map.texturePath.data(), map.texturePath.size());
+    for (const TileProperties& properties : map.properties) {
+        MapFileProperty entry = { static_cast<uint8_t>(properties.walkable ? 1 : 0), properties.moveCost, properties.triggerFlags, 0 };
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    const char padding[MAP_FILE_GRID_ALIGNMENT] = {};
+    file.write(padding, header.gridOffset - tableEnd);
+    file.write(reinterpret_cast<const char*>(map.grid.data()), map.grid.size() * sizeof(TileGrid::TileId));
+
+    if (!file) {
+        std::cerr << "Failed to write binary map file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
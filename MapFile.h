@@ -0,0 +1,100 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include "TileGrid.h"
+#include "TileProperties.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Descrição completa de um mapa, sem nenhuma dependência da OpenGL
+// É preenchida pelos leitores de mapa e usada pelo Tilemap e pela ferramenta de conversão (tools/MapConverter.cpp)
+struct MapDescription {
+    std::string texturePath;                // Caminho da spritesheet
+    int tileCount = 0;                      // Quantidade de texturas diferentes
+    int tileColumns = 1, tileRows = 1;      // Grid da spritesheet
+    std::vector<TileProperties> properties; // Propriedades de cada índice de textura
+    TileGrid grid;                          // Índices de textura do mapa
+};
+
+// Formato binário do mapa (extensão .gbmap), em little-endian:
+//   MapFileHeader
+//   caminho da textura (texturePathLength bytes, sem '\0')
+//   propertyCount x MapFileProperty
+//   preenchimento até gridOffset (alinhado a MAP_FILE_GRID_ALIGNMENT)
+//   grid width x height de uint16_t em ordem de linha, igual ao buffer do TileGrid
+const char MAP_FILE_MAGIC[4] = { 'G', 'B', 'M', 'P' };
+const uint32_t MAP_FILE_VERSION = 1;
+const uint32_t MAP_FILE_GRID_ALIGNMENT = 16;
+
+// Cabeçalho do arquivo de mapa binário
+struct MapFileHeader {
+    char magic[4];              // MAP_FILE_MAGIC
+    uint32_t version;           // MAP_FILE_VERSION
+    uint32_t width, height;     // Dimensões da grid em tiles
+    uint32_t tileCount;         // Quantidade de texturas diferentes
+    uint32_t tileColumns;       // Colunas da spritesheet
+    uint32_t tileRows;          // Linhas da spritesheet
+    uint32_t propertyCount;     // Entradas da tabela de propriedades
+    uint32_t texturePathLength; // Bytes do caminho da textura
+    uint32_t gridOffset;        // Posição da grid a partir do início do arquivo
+};
+
+// Entrada da tabela de propriedades no arquivo binário
+struct MapFileProperty {
+    uint8_t walkable;           // 0 ou 1
+    uint8_t moveCost;           // Custo de movimento
+    uint8_t triggerFlags;       // Combinação de TileTrigger
+    uint8_t reserved;           // Mantém a entrada em 4 bytes
+};
+
+static_assert(sizeof(MapFileHeader) == 40, "MapFileHeader must match the on-disk layout");
+static_assert(sizeof(MapFileProperty) == 4, "MapFileProperty must match the on-disk layout");
+
+// Arquivo mapeado em memória somente para leitura, com cópia na escrita:
+// as páginas são lidas do disco sob demanda e alterações (changeTileTexture) não voltam para o arquivo
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // O mapeamento tem um único dono, por isso não pode ser copiado
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Mapeia o arquivo inteiro; retorna false se não for possível abrir ou mapear
+    bool open(const std::string& path);
+
+    // Desfaz o mapeamento
+    void close();
+
+    // Métodos para obter o início e o tamanho do mapeamento
+    unsigned char* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+private:
+    unsigned char* data;        // Início do arquivo na memória
+    size_t size;                // Tamanho do arquivo em bytes
+#ifdef _WIN32
+    void* fileHandle;           // HANDLE do arquivo
+    void* mappingHandle;        // HANDLE do mapeamento
+#endif
+};
+
+// Indica se o caminho é de um mapa binário (extensão .gbmap)
+bool isBinaryMapPath(const std::string& path);
+
+// Lê um mapa no formato texto (map.txt); erros de formato são informados com linha e coluna
+bool loadTextMap(const std::string& path, MapDescription& map);
+
+// Interpreta um mapa no formato texto já em memória; 'name' identifica a origem nas mensagens de erro
+bool parseTextMap(const char* begin, const char* end, const std::string& name, MapDescription& map);
+
+// Mapeia um mapa binário; a grid do mapa aponta direto para o arquivo mapeado, que deve sobreviver a ela
+bool loadBinaryMap(const std::string& path, MappedFile& file, MapDescription& map);
+
+// Grava um mapa no formato binário
+bool writeBinaryMap(const std::string& path, const MapDescription& map);
+
+#endif
@@ -1,5 +1,9 @@
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <algorithm>
+#include <vector>
+#include <climits>
 #include <assert.h>
 #include <windows.h>
 
@@ -17,53 +21,102 @@
 
 using namespace std;
 
-// Classe para manipulao dos shaders
+// Classe para manipulação dos shaders
 #include "Shader.h"
 
-// Prottipo da funo de callback de teclado
+// Uniform buffer com as matrizes da câmera
+#include "CameraBuffer.h"
+
+// Ritmo dos frames (vsync, limite de quadros e desenho sob demanda)
+#include "FramePacer.h"
+
+// Thread de desenho, dona do contexto OpenGL
+#include "RenderThread.h"
+
+// Trabalhos da atualização distribuídos entre os núcleos
+#include "JobSystem.h"
+
+// Protótipo da função de callback de teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 
-// Funes auxiliares da lgica do jogo
+// Funções auxiliares da lógica do jogo
 void textureChanges(Tilemap& tilemap, int x, int y);
 void potionTracker(int x, int y);
 void winCondition(Tilemap& tilemap, int x, int y);
+bool moveDirectionForKey(int key, MoveDirection& direction);
 
-// Dimenses da janela (pode ser alterado em tempo de execuo)
+// Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Cmera
+// Ritmo dos frames no início; a tecla F troca entre vsync, vsync adaptativo, limite de quadros e desenho sob demanda
+const PacingMode PACING_MODE = PACING_VSYNC;
+
+// Forma do tileset na GPU: TILESET_SHEET usa a spritesheet (ou o atlas) e TILESET_ARRAY uma textura array com um frame por camada
+const TilesetMode TILESET_MODE = TILESET_SHEET;
+
+// Janela do jogo; a thread principal não tem o contexto atual depois que a thread de desenho começa
+GLFWwindow* gameWindow = nullptr;
+
+// Câmera
 glm::vec3 cameraPos; 
 
-// Controlador
-CharacterController* controller = nullptr;
+// Eventos de teclado aguardando o próximo passo da simulação
+InputQueue inputQueue;
 
 // Potion Counter
 bool potionCheck1 = false;
 bool potionCheck2 = false;
 
+// Ordenação da cena: false usa a ordem de pintura (tiles e entidades intercalados), true usa o depth buffer (tecla B)
+bool useDepthBuffer = false;
+
+// Pedido de troca do modo de ritmo dos frames (tecla F)
+bool cyclePacingMode = false;
+
 // Tempo Delta
 double time_now, time_old, time_delta;
 
-// Funo MAIN
+// Passo fixo da simulação: animações, movimento e câmera avançam sempre SIMULATION_STEP segundos por vez,
+// independente da taxa de quadros
+const double SIMULATION_STEP = 1.0 / 60.0;
+
+// Menores faixas dos parallel for da atualização: abaixo disso o custo de dividir passa o ganho
+const size_t ANIMATION_GRAIN = 256;         // Sprites animados por tarefa
+const size_t TRANSFORM_GRAIN = 64;          // Blocos do TransformSystem por tarefa (4 entidades cada)
+const size_t CULLING_GRAIN = 256;           // Sprites testados contra a tela por tarefa
+
+// Animação de um sprite: a faixa de frames da spritesheet percorrida a cada passo
+struct SpriteAnimation {
+    Sprite* sprite;
+    int columns, rows;
+    int startFrameX, startFrameY, endFrameX, endFrameY;
+};
+
+// Maior tempo de frame somado ao acumulador: depois de uma pausa longa (janela arrastada, breakpoint) a simulação
+// não tenta recuperar todos os passos perdidos de uma vez
+const double MAX_FRAME_TIME = 0.25;
+
+// Função MAIN
 int main()
 {
-    // Inicializao da GLFW
+    // Inicialização da GLFW
     glfwInit();
 
-    // Criao da janela GLFW
+    // Criação da janela GLFW
     GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Jogo GB", nullptr, nullptr);
     glfwMakeContextCurrent(window);
+    gameWindow = window;
 
-    // Fazendo o registro da funo de callback para a janela GLFW
+    // Fazendo o registro da função de callback para a janela GLFW
     glfwSetKeyCallback(window, key_callback);
 
-    // GLAD: carrega todos os ponteiros de funes da OpenGL
+    // GLAD: carrega todos os ponteiros de funções da OpenGL
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
         cout << "Failed to initialize GLAD" << endl;
     }
 
-    // Obtendo as informaes de verso
+    // Obtendo as informações de versão
     const GLubyte* renderer = glGetString(GL_RENDERER); /* get renderer string */
     const GLubyte* version = glGetString(GL_VERSION); /* version as a string */
     cout << "Renderer: " << renderer << endl;
@@ -72,44 +125,67 @@ int main()
     // Compilando e buildando o programa de shader
     Shader shader("tex.vs", "tex.fs");
 
-    // Ativando o buffer de textura 0 da opengl
-    glActiveTexture(GL_TEXTURE0);
-
-    // Ativa o shader
-    shader.Use();
+    // Shader dos tiles: desenha o mapa inteiro por instâncias (x, y, textura)
+    Shader tileShader("tile.vs", TILESET_MODE == TILESET_ARRAY ? "tileArray.fs" : "tex.fs");
 
-    // Matriz de projeo paralela ortogrfica
+    // Matriz de projeção paralela ortográfica
     glm::mat4 projection = glm::ortho(0.0, static_cast<double>(WIDTH), 0.0, static_cast<double>(HEIGHT), -1.0, 1.0);
 
-    // Enviando para o shader a matriz como uma var uniform
-    shader.setMat4("projection", glm::value_ptr(projection));
+    // Uniform buffer da câmera: a projeção é enviada uma vez e vale para todos os shaders
+    CameraBuffer camera;
+    camera.setProjection(projection);
+
+    // Fila de desenho do frame
+    RenderQueue renderQueue;
+
+    // Texturas carregadas em segundo plano: os objetos aparecem com o placeholder e a imagem chega em fatias,
+    // sem travar os frames ao carregar mapas ou spritesheets novas
+    TextureCache::startStreaming();
+
+    // Atlas de texturas gerado por tools/AtlasPacker.cpp: quando existe, os sprites e os tiles usam a mesma textura
+    if (std::ifstream("Assets/atlas.txt").good()) {
+        TextureCache::loadAtlas("Assets/atlas.txt");
+    }
 
-    // Criao dos objetos a serem renderizados
-    Tilemap tilemap(shader, "Assets/map.txt", WIDTH, HEIGHT);
-    Sprite* potionLocationSprite1 = tilemap.findSpriteByTilePosition(glm::vec3(4,5,0));
-    glm::vec3 potionLocationPosition1 = potionLocationSprite1->getPosition();
-    glm::vec3 potionLocationTilePosition1 = potionLocationSprite1->getTilePosition();
+    // Criação dos objetos a serem renderizados
+    Tilemap tilemap(tileShader, "Assets/map.txt", WIDTH, HEIGHT, TILESET_MODE);
+    Tile potionLocationTile1;
+    tilemap.getTile(4, 5, potionLocationTile1);
+    glm::vec3 potionLocationPosition1 = potionLocationTile1.getPosition();
+    glm::vec3 potionLocationTilePosition1 = potionLocationTile1.getTilePosition();
 
-    Sprite* potionLocationSprite2 = tilemap.findSpriteByTilePosition(glm::vec3(9, 10, 0));
-    glm::vec3 potionLocationPosition2 = potionLocationSprite2->getPosition();
-    glm::vec3 potionLocationTilePosition2 = potionLocationSprite2->getTilePosition();
+    Tile potionLocationTile2;
+    tilemap.getTile(9, 10, potionLocationTile2);
+    glm::vec3 potionLocationPosition2 = potionLocationTile2.getPosition();
+    glm::vec3 potionLocationTilePosition2 = potionLocationTile2.getTilePosition();
 
     Sprite potion1(shader, "Assets/Util/PotionsSheet.png", glm::vec3(potionLocationPosition1.x, potionLocationPosition1.y + 45.0f, potionLocationPosition1.z), potionLocationTilePosition1, glm::vec3(50.0f, 50.0f, 0.0f), 0.0f);
     Sprite potion2(shader, "Assets/Util/PotionsSheet.png", glm::vec3(potionLocationPosition2.x, potionLocationPosition2.y + 45.0f, potionLocationPosition2.z), potionLocationTilePosition2, glm::vec3(50.0f, 50.0f, 0.0f), 0.0f);
 
 
     // Initial Position
-    Sprite* initialSprite = tilemap.findSpriteByTilePosition(glm::vec3(14, 14, 0.0f));
-    glm::vec3 initialPosition = initialSprite->getPosition();
+    Tile initialTile;
+    tilemap.getTile(14, 14, initialTile);
+    glm::vec3 initialPosition = initialTile.getPosition();
     cameraPos = glm::vec3(initialPosition.x - WIDTH / 2, initialPosition.y - HEIGHT / 2, initialPosition.z);
     initialPosition.y += 85.0f;
-    glm::vec3 initialTilePosition = initialSprite->getTilePosition();
+    glm::vec3 initialTilePosition = initialTile.getTilePosition();
 
     // Controller
     CharacterController character(shader, "Assets/Character/CharacterSheet_CharacterFront.png", initialPosition, initialTilePosition, glm::vec3(150.0f, 150.0f, 0.0f), 0.0f, tilemap);
-    controller = &character;
 
-    // Definindo as dimenses da viewport com as mesmas dimenses da janela da aplicao
+    // Entidades do mundo em ordem de pintura; só as que mudam de tile são reposicionadas a cada frame
+    EntityDepthOrder depthOrder;
+    int characterDepth = depthOrder.add(character.getDepthDiagonal(), static_cast<int>(initialTilePosition.x));
+    int potionDepth1 = depthOrder.add(potion1.getDepthDiagonal(), static_cast<int>(potionLocationTilePosition1.x));
+    int potionDepth2 = depthOrder.add(potion2.getDepthDiagonal(), static_cast<int>(potionLocationTilePosition2.x));
+
+    // Corte de transparência dos shaders: no modo com depth buffer os pixels transparentes não gravam profundidade
+    Uniform<float> spriteAlphaCutoff = shader.getUniform<float>("alphaCutoff");
+    Uniform<float> tileAlphaCutoff = tileShader.getUniform<float>("alphaCutoff");
+    bool depthBufferEnabled = false;
+
+    // Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
     int width, height;
     glfwGetFramebufferSize(window, &width, &height);
     glViewport(0, 0, width, height); // unidades de tela: pixel
@@ -117,106 +193,336 @@ int main()
     // Animation
     time_now = time_old = glfwGetTime();
 
-    // Animation frame rate control
-    double targetFrameRate = 60.0; // Frame Rate
-    double targetFrameTime = 1.0 / targetFrameRate; // Tempo por frame
-
-    // Cmera posicionamento
-    glm::mat4 view = glm::translate(glm::mat4(1.0f), -cameraPos);
-
-    // Loop da aplicao - "game loop"
-    while (!glfwWindowShouldClose(window))
-    {
-        // Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funes de callback correspondentes
-        glfwPollEvents();
+    // Tempo ainda não simulado; o que sobra depois dos passos (menos de um passo) vira a interpolação do desenho
+    double accumulator = 0.0;
+
+    // Eventos de entrada lidos no passo e latência da entrada até o movimento, somada a cada passo
+    std::vector<InputEvent> tickEvents;
+    InputLatencyStats inputLatency;
+
+    // Momento da última atualização das estatísticas de estado no título da janela
+    double statsTime = time_now;
+
+    // Câmera posicionamento; a câmera desenhada é interpolada entre a posição do passo anterior e a do último
+    glm::vec3 previousCameraPos = cameraPos;
+
+    // Ritmo dos frames: sem ele o laço ocupa um núcleo e a GPU mesmo com a tela parada
+    // Criado com o contexto ainda na thread principal; depois disso só a thread de desenho usa o pacer
+    FramePacer pacer(window, PACING_MODE);
+    PacingMode pacingMode = PACING_MODE;
+
+    // Se nada mudou no último frame; no desenho sob demanda o próximo frame só começa com um evento ou no timeout
+    bool sceneIdle = false;
+    uint64_t frameNumber = 0;
+
+    // Trabalhos da atualização: a thread principal executa os grafos junto com as threads do JobSystem
+    JobSystem jobs;
+    JobRunStats jobStats;
+
+    // Estado lido pelos trabalhos; os grafos são montados uma vez e capturam estas variáveis por referência
+    const float step = static_cast<float>(SIMULATION_STEP);
+    int tickTileX = 0, tickTileY = 0;
+    float alpha = 0.0f;
+    glm::vec3 renderCameraPos = cameraPos;
+    std::vector<SpriteAnimation> animations = {
+        { &character, 5, 3, 0, 0, 3, 0 },
+        { &potion1, 2, 8, 0, 7, 1, 7 },
+        { &potion2, 2, 8, 0, 6, 1, 6 }
+    };
+    std::vector<const Sprite*> frameSprites;
+    std::vector<uint8_t> spriteVisible;
+    std::vector<SpriteDraw> spriteDraws;
+    std::atomic<size_t> transformsUpdated(0);
+
+    // Passo da simulação: as animações (frame da spritesheet) avançam junto com o movimento (posição, direção e
+    // transformação), já que não dividem nenhum campo; os gatilhos do mapa (poções, vitória) esperam o movimento,
+    // que lê a caminhabilidade que eles alteram
+    JobGraph tickGraph;
+    tickGraph.addParallelFor("animation", animations.size(), ANIMATION_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const SpriteAnimation& animation = animations[i];
+            animation.sprite->updateTextureCoordsAnimated(animation.columns, animation.rows, step,
+                animation.startFrameX, animation.startFrameY, animation.endFrameX, animation.endFrameY);
+        }
+    });
+    JobGraph::JobId movementJob = tickGraph.add("movement", [&] {
+        character.update(step);
+        cameraPos = character.updateCameraPosition(step, cameraPos, WIDTH, HEIGHT);
+    });
+    JobGraph::JobId triggerJob = tickGraph.add("triggers", [&] {
+        textureChanges(tilemap, tickTileX, tickTileY);
+    });
+    tickGraph.addDependency(triggerJob, movementJob);
+
+    // Frame: as matrizes são recalculadas por faixas de blocos enquanto a ordem de pintura é atualizada, e depois
+    // os sprites são testados contra a tela e montados para o pacote
+    JobGraph frameGraph;
+    JobGraph::JobId transformJob = frameGraph.addParallelFor("transforms", 0, TRANSFORM_GRAIN, [&](size_t begin, size_t end) {
+        transformsUpdated.fetch_add(TransformSystem::updateBlocks(begin, end, alpha), std::memory_order_relaxed);
+    });
+    frameGraph.add("depth order", [&] {
+        depthOrder.move(characterDepth, character.getDepthDiagonal(), static_cast<int>(character.getTilePosition().x));
+        if (potionCheck1 && potionDepth1 >= 0) {
+            depthOrder.remove(potionDepth1);
+            potionDepth1 = -1;
+        }
+        if (potionCheck2 && potionDepth2 >= 0) {
+            depthOrder.remove(potionDepth2);
+            potionDepth2 = -1;
+        }
+        depthOrder.update();
+    });
+    JobGraph::JobId cullingJob = frameGraph.addParallelFor("culling", 0, CULLING_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            spriteVisible[i] = frameSprites[i]->isVisible(renderCameraPos, static_cast<float>(WIDTH), static_cast<float>(HEIGHT));
+            if (spriteVisible[i]) {
+                spriteDraws[i] = frameSprites[i]->makeDraw();
+            }
+        }
+    });
+    frameGraph.addDependency(cullingJob, transformJob);
+
+    // Desenho de um frame, executado na thread de desenho: tudo que toca a OpenGL fica aqui, e a simulação só
+    // conversa com ele pelo FramePacket
+    auto renderFrame = [&](const FramePacket& packet, RenderFrameStats& frameStats) {
+        if (packet.pacingMode != pacer.getMode()) {
+            pacer.setMode(packet.pacingMode);
+        }
 
-        // Calcular o tempo delta
-        time_now = glfwGetTime();
-        time_delta = time_now - time_old;
+        // Liga ou desliga o teste de profundidade quando o modo muda
+        if (packet.depthBuffer != depthBufferEnabled) {
+            depthBufferEnabled = packet.depthBuffer;
+            if (depthBufferEnabled) {
+                glEnable(GL_DEPTH_TEST);
+                glDepthFunc(GL_LEQUAL);
+            }
+            else {
+                glDisable(GL_DEPTH_TEST);
+            }
+            float cutoff = depthBufferEnabled ? 0.5f : 0.0f;
+            shader.Use();
+            shader.set(spriteAlphaCutoff, cutoff);
+            tileShader.Use();
+            tileShader.set(tileAlphaCutoff, cutoff);
+        }
 
-        // Limpa o buffer de cor
+        // Limpa o buffer de cor (e o de profundidade, quando usado)
         glClearColor(0.680, 0.9451, 0.9451, 1.0f); // cor de fundo
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        // Cmera control
-        view = glm::translate(glm::mat4(1.0f), -cameraPos);
-        shader.setMat4("view", glm::value_ptr(view));
-
-        // Game Logic
-        glm::vec3 characterPosition = character.getTilePosition();
-        int x = characterPosition.x;
-        int y = characterPosition.y;
-
-        // Atualiza a animao com base na frame rate
-        if (time_delta >= targetFrameTime) {
-            time_old = time_now;
-
-            // Atualiza animao 
-            character.updateTextureCoordsAnimated(5, 3, time_delta, 0, 0, 3, 0);
-            potion1.updateTextureCoordsAnimated(2, 8, time_delta, 0, 7, 1, 7);
-            potion2.updateTextureCoordsAnimated(2, 8, time_delta, 0, 6, 1, 6);
+        glClear(depthBufferEnabled ? (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT) : GL_COLOR_BUFFER_BIT);
 
-            // Atualiza o personagem na tela
-            character.update(time_delta);
-            cameraPos = character.updateCameraPosition(time_delta, cameraPos, WIDTH, HEIGHT);
-            potion1.updateSprite();
-            potion2.updateSprite();
+        // Câmera control
+        camera.setView(packet.view);
 
-            // Atualiza tilemap
-            textureChanges(tilemap, x, y);
+        // Trocas de tiles feitas pela simulação e uma fatia das texturas em carregamento
+        tilemap.applyTileEdits(packet.tileEdits);
+        TextureCache::update();
 
-        }
-
-        // Chamadas de desenho da cena
-        tilemap.drawTiles();
-       
-        if (!potionCheck1) {
-            potion1.draw();
-        }
+        // Atualiza os chunks do mapa próximos da câmera (somente em mapas grandes)
+        tilemap.update(packet.cameraPos);
 
-        if (!potionCheck2) {
-            potion2.draw();
+        // Envia a cena para a fila de desenho: a ordem final vem das chaves de ordenação, não da ordem de envio
+        // Com o depth buffer o mapa visível vai inteiro em um comando e a profundidade de cada pixel decide a ordem
+        tilemap.submit(renderQueue, packet.cameraPos, depthBufferEnabled ? nullptr : &packet.entityDiagonals);
+        for (const SpriteDraw& draw : packet.sprites) {
+            renderQueue.submit(draw);
         }
 
-        character.draw();
+        // Ordena e desenha a cena, agrupando os sprites que usam o mesmo shader e textura
+        renderQueue.flush();
 
-        // Troca os buffers da tela
+        // Troca os buffers da tela e segura o próximo frame conforme o modo de ritmo
         glfwSwapBuffers(window);
+        pacer.endFrame();
+
+        // Fecha a contagem de trocas de estado do frame
+        RenderState::endFrame();
+        const RenderStats& stats = RenderState::getLastFrameStats();
+        frameStats.itemCount = renderQueue.getItemCount();
+        frameStats.drawCount = renderQueue.getDrawCount();
+        frameStats.stateChangesIssued = stats.issued;
+        frameStats.stateChangesElided = stats.elided;
+        frameStats.pendingTextures = TextureCache::getPendingCount();
+        frameStats.idleFraction = pacer.getIdleFraction();
+    };
+
+    // A partir daqui o contexto OpenGL pertence à thread de desenho; a thread principal fica com os eventos,
+    // a simulação e o título da janela
+    {
+        RenderThread renderThread(window, renderFrame);
+
+        // Loop da aplicação - "game loop"
+        while (!glfwWindowShouldClose(window))
+        {
+            // Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+            FramePacer::pollEvents(pacingMode, sceneIdle);
+            if (cyclePacingMode) {
+                cyclePacingMode = false;
+                pacingMode = static_cast<PacingMode>((pacingMode + 1) % PACING_MODE_COUNT);
+            }
+
+            // Calcular o tempo delta
+            time_now = glfwGetTime();
+            time_delta = time_now - time_old;
+            time_old = time_now;
+            accumulator += std::min(time_delta, MAX_FRAME_TIME);
+
+            // Simulação: executa quantos passos fixos couberem no tempo acumulado (nenhum, em telas rápidas)
+            while (accumulator >= SIMULATION_STEP) {
+                accumulator -= SIMULATION_STEP;
+                // Guarda o estado do fim do passo anterior para a interpolação
+                TransformSystem::beginTick();
+                previousCameraPos = cameraPos;
+
+                // Entrada: os movimentos pedidos desde o último passo, na ordem em que as teclas chegaram
+                inputQueue.drain(tickEvents);
+                for (const InputEvent& event : tickEvents) {
+                    MoveDirection direction;
+                    if (!moveDirectionForKey(event.key, direction)) {
+                        continue;
+                    }
+                    if (event.action == GLFW_RELEASE) {
+                        character.releaseMove(direction);
+                    }
+                    else {
+                        character.queueMove(direction, event.time, event.action == GLFW_REPEAT);
+                    }
+                }
+
+                // Game Logic: os gatilhos usam o tile do personagem no início do passo
+                glm::vec3 characterPosition = character.getTilePosition();
+                tickTileX = characterPosition.x;
+                tickTileY = characterPosition.y;
+
+                // Animação, movimento, câmera e gatilhos do mapa
+                jobs.run(tickGraph);
+                jobStats.merge(jobs.getLastRunStats());
+
+                // Latência dos movimentos iniciados neste passo
+                inputLatency.merge(character.takeLatencyStats());
+            }
+
+            // Fração do próximo passo já decorrida: o desenho fica entre o passo anterior e o último
+            alpha = static_cast<float>(accumulator / SIMULATION_STEP);
+            renderCameraPos = glm::mix(previousCameraPos, cameraPos, alpha);
+
+            // Sprites do frame; as poções coletadas saem da cena
+            frameSprites.clear();
+            if (!potionCheck1) {
+                frameSprites.push_back(&potion1);
+            }
+            if (!potionCheck2) {
+                frameSprites.push_back(&potion2);
+            }
+            frameSprites.push_back(&character);
+            spriteVisible.assign(frameSprites.size(), 0);
+            spriteDraws.resize(frameSprites.size());
+
+            // Matrizes com a posição interpolada, ordem de pintura e culling dos sprites
+            transformsUpdated.store(0, std::memory_order_relaxed);
+            // Sem nenhuma entidade suja ou em movimento as faixas não teriam o que fazer; o trabalho fica vazio
+            frameGraph.setCount(transformJob, TransformSystem::hasPendingUpdate() ? TransformSystem::getBlockCount() : 0);
+            frameGraph.setCount(cullingJob, frameSprites.size());
+            jobs.run(frameGraph);
+            TransformSystem::finishUpdate(transformsUpdated.load(std::memory_order_relaxed));
+            jobStats.merge(jobs.getLastRunStats());
+
+            // Monta o pacote do frame para a thread de desenho
+            FramePacket& packet = renderThread.beginPacket();
+            packet.frame = ++frameNumber;
+            packet.cameraPos = renderCameraPos;
+            packet.view = glm::translate(glm::mat4(1.0f), -renderCameraPos);
+            packet.depthBuffer = useDepthBuffer;
+            packet.pacingMode = pacingMode;
+            depthOrder.diagonalsInRange(INT_MIN, INT_MAX, packet.entityDiagonals);
+            tilemap.copyTileEdits(packet.tileEdits);
+            for (size_t i = 0; i < frameSprites.size(); ++i) {
+                if (spriteVisible[i]) {
+                    packet.sprites.push_back(spriteDraws[i]);
+                }
+            }
+
+            // Publica o frame e espera a thread de desenho pegá-lo, no máximo um passo: a simulação fica um frame à
+            // frente do desenho, e uma GPU lenta faz frames serem descartados em vez de atrasar a lógica
+            renderThread.publish();
+            renderThread.waitForConsumption(SIMULATION_STEP);
+            RenderFrameStats renderStats = renderThread.getStats();
+
+            // A cena está parada quando o personagem não anda, a câmera já chegou e nenhuma textura está carregando;
+            // as animações das poções e do personagem continuam no ritmo do timeout do FramePacer
+            sceneIdle = !character.getMoving() && glm::distance(previousCameraPos, cameraPos) < 0.01f && renderStats.pendingTextures == 0;
+
+            // Mostra as estatísticas do desenho no título da janela uma vez por segundo
+            if (time_now - statsTime >= 1.0) {
+                statsTime = time_now;
+                std::string title = "Jogo GB - draws: " + std::to_string(renderStats.drawCount) + " sprite batches for " + std::to_string(renderStats.itemCount)
+                    + " items, state changes: " + std::to_string(renderStats.stateChangesIssued) + " issued, " + std::to_string(renderStats.stateChangesElided) + " elided"
+                    + (useDepthBuffer ? " [depth buffer]" : " [painter]")
+                    + " [" + FramePacer::getModeName(pacingMode) + ", idle " + std::to_string(static_cast<int>(renderStats.idleFraction * 100.0)) + "%]"
+                    + ", render " + std::to_string(static_cast<int>(renderStats.renderTime * 1000.0)) + " ms, " + std::to_string(frameNumber - renderStats.framesRendered) + " frames skipped";
+                if (inputLatency.count > 0) {
+                    title += ", input latency " + std::to_string(static_cast<int>(inputLatency.average() * 1000.0)) + " ms avg / "
+                        + std::to_string(static_cast<int>(inputLatency.max * 1000.0)) + " ms max";
+                    inputLatency = InputLatencyStats();
+                }
+                title += ", jobs";
+                for (size_t i = 0; i < jobStats.workers.size(); ++i) {
+                    title += (i == 0 ? " " : "/") + std::to_string(static_cast<int>(jobStats.utilization(i) * 100.0));
+                }
+                title += "%";
+                jobStats = JobRunStats();
+                if (renderStats.pendingTextures > 0) {
+                    title += ", loading " + std::to_string(renderStats.pendingTextures) + " textures";
+                }
+                glfwSetWindowTitle(window, title.c_str());
+            }
+        }
     }
 
-    // Finaliza a execuo da GLFW, limpando os recursos alocados por ela
+    // Para o carregamento de texturas enquanto o contexto OpenGL ainda existe (de volta à thread principal)
+    TextureCache::stopStreaming();
+
+    // Finaliza a execução da GLFW, limpando os recursos alocados por ela
     glfwTerminate();
     return 0;
 }
 
-// Funo de callback de teclado
+// Função de callback de teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode)
 {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, GL_TRUE);
 
-    // Input do jogador para controlar o movimento do personagem
-    if (!controller->getMoving()) {
-        if (key == GLFW_KEY_W && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveNorth(time_delta);
-        if (key == GLFW_KEY_S && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveSouth(time_delta);
-        if (key == GLFW_KEY_A && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveWest(time_delta);
-        if (key == GLFW_KEY_D && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveEast(time_delta);
-        if (key == GLFW_KEY_E && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveNorthEast(time_delta);
-        if (key == GLFW_KEY_Q && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveNorthWest(time_delta);
-        if (key == GLFW_KEY_C && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveSouthWest(time_delta);
-        if (key == GLFW_KEY_Z && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            controller->moveSouthEast(time_delta);
+    // Alterna entre a ordem de pintura e o depth buffer para comparação
+    if (key == GLFW_KEY_B && action == GLFW_PRESS)
+        useDepthBuffer = !useDepthBuffer;
+
+    // Passa para o próximo modo de ritmo dos frames
+    if (key == GLFW_KEY_F && action == GLFW_PRESS)
+        cyclePacingMode = true;
+
+    // Input do jogador: guardado com o momento de chegada e tratado no início do próximo passo da simulação
+    // Soltar a tecla também entra na fila, para descartar a repetição guardada enquanto ela estava segurada
+    MoveDirection direction;
+    if (moveDirectionForKey(key, direction))
+        inputQueue.push(key, action, glfwGetTime());
+}
+
+// Função que converte a tecla de movimento na direção do personagem
+bool moveDirectionForKey(int key, MoveDirection& direction) {
+    switch (key) {
+    case GLFW_KEY_W: direction = MOVE_NORTH; return true;
+    case GLFW_KEY_S: direction = MOVE_SOUTH; return true;
+    case GLFW_KEY_A: direction = MOVE_WEST; return true;
+    case GLFW_KEY_D: direction = MOVE_EAST; return true;
+    case GLFW_KEY_E: direction = MOVE_NORTH_EAST; return true;
+    case GLFW_KEY_Q: direction = MOVE_NORTH_WEST; return true;
+    case GLFW_KEY_C: direction = MOVE_SOUTH_WEST; return true;
+    case GLFW_KEY_Z: direction = MOVE_SOUTH_EAST; return true;
+    default: return false;
     }
 }
 
-// Funo para atualizar 
+// Função para atualizar 
 void textureChanges(Tilemap& tilemap, int x, int y) {  
 
     if (x == 14 && y == 1) {
@@ -258,7 +564,7 @@ void textureChanges(Tilemap& tilemap, int x, int y) {
     winCondition(tilemap,x, y);
 }
 
-// Funo para checar a contagem de poes
+// Função para checar a contagem de poções
 void potionTracker(int x, int y) {
 
     // Potion 1 
@@ -273,14 +579,14 @@ void potionTracker(int x, int y) {
 
 }
 
-// Funo para checar se o jogador ganhou
+// Função para checar se o jogador ganhou
 void winCondition(Tilemap& tilemap, int x, int y) {
 
     if (potionCheck1 && potionCheck2) {
         tilemap.changeTileTexture(0, 0, 72);
         if (x == 0 && y == 0) {
             // Close the game window
-            glfwSetWindowShouldClose(glfwGetCurrentContext(), GL_TRUE);
+            glfwSetWindowShouldClose(gameWindow, GL_TRUE);
         }
     }
 }
\ No newline at end of file
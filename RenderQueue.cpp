@@ -0,0 +1,212 @@
+#include "RenderQueue.h"
+#include "RenderState.h"
+#include "SharedQuad.h"
+#include "Texture.h"
+#include <GLFW/glfw3.h>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+const uint32_t RenderQueue::MAX_DEPTH;
+
+// Construtor da classe RenderQueue
+RenderQueue::RenderQueue()
+    : lastItemCount(0), lastDrawCount(0), VAO(0), instanceVBO(0), instanceCapacity(0) {
+}
+
+// Função que converte a matriz de modelo e o frame para o formato compacto da GPU
+void SpriteInstance::set(const Affine2D& model, const glm::vec4& frame, float z) {
+    translation = glm::vec2(model.tx, model.ty);
+    linear[0] = glm::packHalf1x16(model.a);
+    linear[1] = glm::packHalf1x16(model.b);
+    linear[2] = glm::packHalf1x16(model.c);
+    linear[3] = glm::packHalf1x16(model.d);
+    for (int i = 0; i < 4; ++i) {
+        float clamped = std::min(std::max(frame[i], 0.0f), 1.0f);
+        uvRect[i] = static_cast<uint16_t>(std::lround(clamped * 65535.0f));
+    }
+    depth = z;
+}
+
+// Destrutor: libera os buffers somente se ainda houver um contexto OpenGL ativo
+RenderQueue::~RenderQueue() {
+    if (VAO != 0 && glfwGetCurrentContext() != nullptr) {
+        glDeleteVertexArrays(1, &VAO);
+        RenderState::vertexArrayDeleted(VAO);
+        glDeleteBuffers(1, &instanceVBO);
+    }
+    if (VAO != 0) {
+        SharedQuad::release();
+    }
+}
+
+// Função que monta a chave de ordenação
+// Programa e textura entram só com os 16 bits baixos: servem para aproximar itens com o mesmo estado,
+// e o agrupamento compara os valores completos guardados no item
+uint64_t RenderQueue::makeKey(uint8_t layer, uint32_t depth, GLuint program, GLuint texture) {
+    return (static_cast<uint64_t>(layer) << 56)
+        | (static_cast<uint64_t>(std::min(depth, MAX_DEPTH)) << 32)
+        | (static_cast<uint64_t>(program & 0xffff) << 16)
+        | static_cast<uint64_t>(texture & 0xffff);
+}
+
+// Função que converte Y do mundo em profundidade, com precisão de 1/4 de pixel
+uint32_t RenderQueue::depthFromY(float y) {
+    float scaled = y * 4.0f + static_cast<float>(1 << 23);
+    uint32_t height = static_cast<uint32_t>(std::max(0.0f, std::min(scaled, static_cast<float>(MAX_DEPTH))));
+    return MAX_DEPTH - height;
+}
+
+// Função que envia um sprite para a fila
+void RenderQueue::submit(uint64_t key, GLuint program, GLuint texture, const SpriteInstance& instance) {
+    keys.push_back(key);
+    items.push_back(Item{ program, texture, static_cast<uint32_t>(instances.size()), false });
+    instances.push_back(instance);
+}
+
+// Função que envia um sprite montado pela simulação
+void RenderQueue::submit(const SpriteDraw& draw) {
+    GLuint texture = draw.texture ? draw.texture->getID() : 0;
+    submit(makeKey(draw.layer, draw.depth, draw.program, texture), draw.program, texture, draw.instance);
+}
+
+// Função que envia um comando para a fila
+void RenderQueue::submitCommand(uint64_t key, CommandFunction function, const void* context) {
+    keys.push_back(key);
+    items.push_back(Item{ 0, 0, static_cast<uint32_t>(commands.size()), true });
+    commands.push_back(Command{ function, context });
+}
+
+// Função que ordena os itens pela chave
+// O radix sort é estável, então itens com a mesma chave mantêm a ordem de envio
+void RenderQueue::sortItems() {
+    size_t count = keys.size();
+    order.resize(count);
+    sortScratch.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    // Bytes que variam entre as chaves; os demais não mudam a ordem e são pulados
+    uint64_t allOnes = ~0ull, anyOnes = 0;
+    for (uint64_t key : keys) {
+        allOnes &= key;
+        anyOnes |= key;
+    }
+    uint64_t varying = allOnes ^ anyOnes;
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xff) == 0) {
+            continue;
+        }
+        size_t offsets[256] = {};
+        for (size_t i = 0; i < count; ++i) {
+            ++offsets[(keys[order[i]] >> shift) & 0xff];
+        }
+        size_t total = 0;
+        for (size_t& offset : offsets) {
+            size_t bucket = offset;
+            offset = total;
+            total += bucket;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            sortScratch[offsets[(keys[order[i]] >> shift) & 0xff]++] = order[i];
+        }
+        order.swap(sortScratch);
+    }
+}
+
+// Função que ordena, agrupa e desenha os itens do frame
+void RenderQueue::flush() {
+    lastItemCount = items.size();
+    lastDrawCount = 0;
+    if (items.empty()) {
+        return;
+    }
+
+    sortItems();
+
+    // Junta sprites vizinhos na ordem de desenho que usam o mesmo programa e textura
+    sorted.clear();
+    batches.clear();
+    for (uint32_t itemIndex : order) {
+        const Item& item = items[itemIndex];
+        if (item.isCommand) {
+            batches.push_back(Batch{ 0, 0, 0, 0, static_cast<int>(item.index) });
+            continue;
+        }
+        if (!batches.empty() && batches.back().command < 0 && batches.back().program == item.program && batches.back().texture == item.texture) {
+            ++batches.back().count;
+        }
+        else {
+            batches.push_back(Batch{ item.program, item.texture, static_cast<GLint>(sorted.size()), 1, -1 });
+        }
+        sorted.push_back(instances[item.index]);
+    }
+
+    if (!sorted.empty()) {
+        if (VAO == 0) {
+            createBuffers();
+        }
+        uploadInstances();
+    }
+
+    for (const Batch& batch : batches) {
+        if (batch.command >= 0) {
+            const Command& command = commands[batch.command];
+            command.function(command.context);
+            continue;
+        }
+
+        RenderState::useProgram(batch.program);
+        RenderState::bindTexture(batch.texture);
+        RenderState::bindVertexArray(VAO);
+
+        // A OpenGL 3.3 não tem baseInstance: o início da sequência é definido deslocando os atributos de instância
+        GLsizei stride = sizeof(SpriteInstance);
+        size_t base = static_cast<size_t>(batch.first) * sizeof(SpriteInstance);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(base + offsetof(SpriteInstance, translation)));
+        glVertexAttribPointer(5, 4, GL_HALF_FLOAT, GL_FALSE, stride, (GLvoid*)(base + offsetof(SpriteInstance, linear)));
+        glVertexAttribPointer(6, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (GLvoid*)(base + offsetof(SpriteInstance, uvRect)));
+        glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(base + offsetof(SpriteInstance, depth)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glDrawElementsInstanced(GL_TRIANGLES, SharedQuad::INDEX_COUNT, SharedQuad::INDEX_TYPE, 0, batch.count);
+        ++lastDrawCount;
+    }
+
+    // Esvazia a fila mantendo a memória para o próximo frame
+    keys.clear();
+    items.clear();
+    instances.clear();
+    commands.clear();
+}
+
+// Função que associa o quad unitário compartilhado e cria o buffer de instâncias
+void RenderQueue::createBuffers() {
+    SharedQuad::acquire();
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &instanceVBO);
+
+    RenderState::bindVertexArray(VAO);                                                  // Vincula o VAO
+    SharedQuad::attach();                                                               // Quad unitário compartilhado
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);                                         // Matriz 2x3, frame e z de cada sprite
+    for (GLuint location = 4; location <= 7; ++location) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);                                             // Avança uma vez por instância
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);                                                   // Desassocia o buffer de vértices
+}
+
+// Função que envia as instâncias do frame
+// O buffer é realocado (orphan) a cada frame para não esperar a GPU terminar de ler o frame anterior
+void RenderQueue::uploadInstances() {
+    instanceCapacity = std::max(instanceCapacity, sorted.size());
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sorted.size() * sizeof(SpriteInstance), sorted.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,136 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "TransformSystem.h"
+#include <cstdint>
+#include <vector>
+
+// Camadas de desenho, da primeira à última a ser desenhada
+enum RenderLayer : uint8_t {
+    RENDER_LAYER_WORLD = 0,     // Tiles e entidades do mundo, intercalados pela profundidade isométrica (IsoDepth.h)
+    RENDER_LAYER_UI = 1         // Interface, sempre por cima
+};
+
+// Dados de um sprite enviados para a GPU: 28 bytes por sprite
+// O shader tex.vs aplica a matriz afim 2x3 (Affine2D) aos cantos do quad unitário compartilhado (SharedQuad)
+// A translação fica em float porque cobre o mapa inteiro; a parte linear (escala e rotação) vai em half float,
+// que erra menos de 0.1 pixel nos tamanhos de sprite do jogo, e o frame em 16 bits normalizados
+struct SpriteInstance {
+    glm::vec2 translation;      // Translação da matriz de modelo (tx, ty)
+    uint16_t linear[4];         // Parte linear da matriz em half float: a, b (linha x) e c, d (linha y)
+    uint16_t uvRect[4];         // Offset (xy) e tamanho (zw) do frame na spritesheet, de 0 a 65535
+    float depth;                // z do sprite, usado quando o teste de profundidade está ligado
+
+    // Preenche a instância a partir da matriz de modelo e do frame (valores de 0 a 1)
+    void set(const Affine2D& model, const glm::vec4& frame, float z);
+};
+
+static_assert(sizeof(SpriteInstance) == 28, "SpriteInstance must match the vertex layout in tex.vs");
+
+class Texture;
+
+// Sprite pronto para a fila, montado sem nenhuma chamada OpenGL (pode vir da thread da simulação)
+// O ID da textura só é lido no RenderQueue::submit, na thread de desenho, porque muda quando o carregamento
+// assíncrono termina; a textura deve existir até lá
+struct SpriteDraw {
+    uint8_t layer;              // Camada de desenho (RenderLayer)
+    uint32_t depth;             // Profundidade na chave de ordenação
+    GLuint program;             // Programa do sprite
+    const Texture* texture;     // Textura do sprite
+    SpriteInstance instance;
+};
+
+// Fila de desenho do frame
+// Cada item enviado carrega uma chave de 64 bits (camada | profundidade | programa | textura); no flush() os
+// itens são ordenados por radix sort e as sequências de sprites com o mesmo programa e textura viram uma
+// única chamada de desenho instanciada. Itens que desenham por conta própria (o tilemap) entram como comandos
+class RenderQueue {
+public:
+    // Função de um comando de desenho; recebe o contexto informado no submitCommand
+    typedef void (*CommandFunction)(const void* context);
+
+    static const uint32_t MAX_DEPTH = 0xffffff;     // Profundidade ocupa 24 bits da chave
+
+    // Construtor: não cria recursos na GPU até o primeiro flush()
+    RenderQueue();
+
+    // Libera os buffers da GPU
+    ~RenderQueue();
+
+    // Os buffers têm um único dono, por isso a fila não pode ser copiada
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Monta a chave de ordenação: camada (8 bits), profundidade (24 bits, menor desenha antes), programa e textura (16 bits cada)
+    static uint64_t makeKey(uint8_t layer, uint32_t depth, GLuint program, GLuint texture);
+
+    // Converte a posição Y no mundo em profundidade: quanto mais alto na tela, mais ao fundo (desenha antes)
+    static uint32_t depthFromY(float y);
+
+    // Envia um sprite para a fila
+    void submit(uint64_t key, GLuint program, GLuint texture, const SpriteInstance& instance);
+
+    // Envia um sprite montado fora da thread de desenho, montando a chave com o ID atual da textura
+    void submit(const SpriteDraw& draw);
+
+    // Envia um comando que desenha por conta própria na posição da chave
+    void submitCommand(uint64_t key, CommandFunction function, const void* context);
+
+    // Ordena, agrupa e desenha todos os itens do frame, esvaziando a fila
+    void flush();
+
+    // Métodos para obter a quantidade de itens e de chamadas de desenho do último flush()
+    size_t getItemCount() const { return lastItemCount; }
+    size_t getDrawCount() const { return lastDrawCount; }
+
+private:
+    // Item da fila: sprite (index em instances) ou comando (index em commands)
+    struct Item {
+        GLuint program;         // Programa do sprite
+        GLuint texture;         // Textura do sprite
+        uint32_t index;         // Posição em instances ou em commands
+        bool isCommand;         // Se o item é um comando
+    };
+
+    // Comando de desenho enviado pelo submitCommand
+    struct Command {
+        CommandFunction function;
+        const void* context;
+    };
+
+    // Passo do desenho: uma sequência de sprites desenhada com uma chamada, ou um comando
+    struct Batch {
+        GLuint program;
+        GLuint texture;
+        GLint first;            // Primeira instância no buffer
+        GLsizei count;          // Quantidade de instâncias
+        int command;            // Índice do comando em commands (-1 em sequências de sprites)
+    };
+
+    // Ordena 'order' pelas chaves com radix sort LSD de 8 bits, pulando os bytes iguais em todas as chaves
+    void sortItems();
+
+    // Associa o quad compartilhado e cria o buffer de instâncias
+    void createBuffers();
+
+    // Envia as instâncias ordenadas para a GPU, aumentando o buffer se necessário
+    void uploadInstances();
+
+    std::vector<uint64_t> keys;             // Chave de cada item, na ordem de envio
+    std::vector<Item> items;                // Itens na ordem de envio
+    std::vector<SpriteInstance> instances;  // Instâncias na ordem de envio
+    std::vector<Command> commands;          // Comandos na ordem de envio
+    std::vector<uint32_t> order;            // Índices dos itens em ordem de desenho
+    std::vector<uint32_t> sortScratch;      // Memória auxiliar do radix sort
+    std::vector<SpriteInstance> sorted;     // Instâncias em ordem de desenho, como vão para a GPU
+    std::vector<Batch> batches;             // Chamadas de desenho do frame
+    size_t lastItemCount, lastDrawCount;    // Estatísticas do último flush()
+
+    GLuint VAO;                 // Quad unitário compartilhado e atributos de instância
+    GLuint instanceVBO;         // Buffer de SpriteInstance
+    size_t instanceCapacity;    // Capacidade do buffer de instâncias em sprites
+};
+
+#endif
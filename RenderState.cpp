@@ -0,0 +1,105 @@
+#include "RenderState.h"
+
+// Valor que nenhum objeto da OpenGL usa como nome: força o próximo vínculo
+static const GLuint UNKNOWN = ~0u;
+
+// Estado inicial de um contexto novo: nada vinculado e unidade 0 ativa
+GLuint RenderState::program = 0;
+GLuint RenderState::vertexArray = 0;
+GLuint RenderState::activeUnit = 0;
+GLuint RenderState::textures[RenderState::MAX_TEXTURE_UNITS][RenderState::TEXTURE_TARGETS] = {};
+RenderStats RenderState::current;
+RenderStats RenderState::lastFrame;
+
+// Função que ativa o programa
+void RenderState::useProgram(GLuint program) {
+    if (RenderState::program == program) {
+        ++current.elided;
+        return;
+    }
+    glUseProgram(program);
+    RenderState::program = program;
+    ++current.issued;
+}
+
+// Função que vincula a textura na unidade informada
+// Cada unidade tem um vínculo separado para cada tipo de textura
+void RenderState::bindTexture(GLuint texture, GLuint unit, GLenum target) {
+    int kind = target == GL_TEXTURE_2D ? 0 : (target == GL_TEXTURE_2D_ARRAY ? 1 : -1);
+    if (unit >= MAX_TEXTURE_UNITS || kind < 0) {
+        // Unidades e tipos além dos acompanhados sempre vão para a OpenGL
+        activeTexture(unit);
+        glBindTexture(target, texture);
+        ++current.issued;
+        return;
+    }
+    if (textures[unit][kind] == texture) {
+        ++current.elided;
+        return;
+    }
+    activeTexture(unit);
+    glBindTexture(target, texture);
+    textures[unit][kind] = texture;
+    ++current.issued;
+}
+
+// Função que vincula o VAO
+void RenderState::bindVertexArray(GLuint vertexArray) {
+    if (RenderState::vertexArray == vertexArray) {
+        ++current.elided;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    RenderState::vertexArray = vertexArray;
+    ++current.issued;
+}
+
+// Função que ativa a unidade de textura
+void RenderState::activeTexture(GLuint unit) {
+    if (activeUnit == unit) {
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+    activeUnit = unit;
+    ++current.issued;
+}
+
+// Funções que atualizam o estado guardado quando um objeto vinculado é excluído
+void RenderState::textureDeleted(GLuint texture) {
+    for (auto& unit : textures) {
+        for (GLuint& bound : unit) {
+            if (bound == texture) {
+                bound = 0;
+            }
+        }
+    }
+}
+
+void RenderState::vertexArrayDeleted(GLuint vertexArray) {
+    if (RenderState::vertexArray == vertexArray) {
+        RenderState::vertexArray = 0;
+    }
+}
+
+void RenderState::programDeleted(GLuint program) {
+    // O programa em uso continua em uso até outro ser ativado, mas o nome pode ser reaproveitado
+    if (RenderState::program == program) {
+        RenderState::program = UNKNOWN;
+    }
+}
+
+// Função que força o próximo vínculo de cada tipo a ir para a OpenGL
+void RenderState::invalidate() {
+    program = vertexArray = activeUnit = UNKNOWN;
+    for (auto& unit : textures) {
+        for (GLuint& bound : unit) {
+            bound = UNKNOWN;
+        }
+    }
+}
+
+// Função que fecha as contagens do frame
+void RenderState::endFrame() {
+    lastFrame = current;
+    current = RenderStats();
+}
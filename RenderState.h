@@ -0,0 +1,53 @@
+#ifndef RENDERSTATE_H
+#define RENDERSTATE_H
+
+#include <glad/glad.h>
+
+// Contagem de trocas de estado da OpenGL em um frame
+struct RenderStats {
+    int issued = 0;             // Trocas enviadas ao driver
+    int elided = 0;             // Trocas descartadas por já estarem no estado pedido
+};
+
+// Classe que guarda o programa, as texturas e o VAO vinculados na OpenGL e ignora
+// vínculos repetidos. Todo vínculo de programa, textura 2D e VAO deve passar por aqui,
+// senão o estado guardado deixa de corresponder ao da OpenGL
+class RenderState {
+public:
+    static const int MAX_TEXTURE_UNITS = 16;   // Unidades de textura acompanhadas
+    static const int TEXTURE_TARGETS = 2;      // Tipos de textura acompanhados: GL_TEXTURE_2D e GL_TEXTURE_2D_ARRAY
+
+    // Métodos que vinculam somente se o objeto pedido for diferente do atual
+    static void useProgram(GLuint program);
+    static void bindTexture(GLuint texture, GLuint unit = 0, GLenum target = GL_TEXTURE_2D);
+    static void bindVertexArray(GLuint vertexArray);
+
+    // Métodos que avisam a exclusão de um objeto: a OpenGL desvincula o objeto excluído
+    // e pode reaproveitar o mesmo nome para um objeto novo
+    static void textureDeleted(GLuint texture);
+    static void vertexArrayDeleted(GLuint vertexArray);
+    static void programDeleted(GLuint program);
+
+    // Esquece o estado guardado (após código externo alterar os vínculos diretamente)
+    static void invalidate();
+
+    // Fecha o frame atual: guarda as contagens do frame e zera as do próximo
+    static void endFrame();
+
+    // Métodos para obter as contagens do último frame fechado e do frame em andamento
+    static const RenderStats& getLastFrameStats() { return lastFrame; }
+    static const RenderStats& getCurrentStats() { return current; }
+
+private:
+    // Ativa a unidade de textura se necessário
+    static void activeTexture(GLuint unit);
+
+    static GLuint program;                              // Programa em uso (0 = nenhum)
+    static GLuint vertexArray;                          // VAO vinculado (0 = nenhum)
+    static GLuint activeUnit;                           // Unidade de textura ativa
+    static GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGETS]; // Textura vinculada em cada unidade, por tipo
+    static RenderStats current;                         // Contagens do frame em andamento
+    static RenderStats lastFrame;                       // Contagens do último frame fechado
+};
+
+#endif
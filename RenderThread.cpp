@@ -0,0 +1,97 @@
+#include "RenderThread.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+const uint32_t RenderThread::INDEX_MASK;
+const uint32_t RenderThread::FRESH_BIT;
+
+// Construtor da classe RenderThread
+RenderThread::RenderThread(GLFWwindow* window, RenderFunction render)
+    : window(window), render(render), writeIndex(0), readIndex(2), shared(1), stopping(false) {
+    // Um contexto só pode estar atual em uma thread por vez
+    glfwMakeContextCurrent(nullptr);
+    thread = std::thread(&RenderThread::renderLoop, this);
+}
+
+// Destrutor: encerra a thread de desenho e retoma o contexto para a liberação dos recursos
+RenderThread::~RenderThread() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    thread.join();
+    glfwMakeContextCurrent(window);
+}
+
+// Função que entrega o pacote da simulação, esvaziado
+FramePacket& RenderThread::beginPacket() {
+    FramePacket& packet = packets[writeIndex];
+    packet.sprites.clear();
+    packet.entityDiagonals.clear();
+    packet.tileEdits.clear();
+    return packet;
+}
+
+// Função que publica o pacote da simulação
+// A troca devolve o pacote compartilhado anterior, que vira o próximo pacote da simulação: se ele ainda não tinha
+// sido lido, é descartado
+void RenderThread::publish() {
+    uint32_t previous = shared.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+    writeIndex = previous & INDEX_MASK;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wakeCondition.notify_all();
+}
+
+// Função que espera a thread de desenho pegar o último pacote
+void RenderThread::waitForConsumption(double timeout) {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wakeCondition.wait_for(lock, std::chrono::duration<double>(timeout), [this] {
+        return stopping || (shared.load(std::memory_order_acquire) & FRESH_BIT) == 0;
+    });
+}
+
+// Função para retornar as medidas do último frame desenhado
+RenderFrameStats RenderThread::getStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+// Função executada pela thread de desenho
+// Sem pacote novo a thread dorme; com um, troca o próprio índice pelo compartilhado e desenha o pacote recebido
+void RenderThread::renderLoop() {
+    glfwMakeContextCurrent(window);
+    RenderFrameStats frameStats;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [this] {
+                return stopping || (shared.load(std::memory_order_acquire) & FRESH_BIT) != 0;
+            });
+            if (stopping) {
+                break;
+            }
+        }
+
+        uint32_t previous = shared.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_all();
+
+        double start = glfwGetTime();
+        render(packets[readIndex], frameStats);
+        frameStats.renderTime = glfwGetTime() - start;
+        ++frameStats.framesRendered;
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats = frameStats;
+        }
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,100 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include "FramePacer.h"
+#include "RenderQueue.h"
+#include "Tilemap.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+
+// Tudo o que a thread de desenho precisa para desenhar um frame, montado pela simulação
+// Depois de publicado o pacote não muda mais; a simulação volta a escrever nele só quando ele retorna pelo rodízio
+struct FramePacket {
+    uint64_t frame = 0;                     // Número do frame da simulação
+    glm::mat4 view = glm::mat4(1.0f);       // Matriz de visão da câmera interpolada
+    glm::vec3 cameraPos = glm::vec3(0.0f);  // Canto inferior esquerdo da tela no mundo (culling do mapa)
+    bool depthBuffer = false;               // Ordem pelo depth buffer em vez da ordem de pintura
+    PacingMode pacingMode = PACING_VSYNC;   // Modo de ritmo dos frames
+    std::vector<SpriteDraw> sprites;        // Sprites do frame, com as matrizes já interpoladas
+    std::vector<int> entityDiagonals;       // Diagonais ocupadas por entidades, em ordem de pintura
+    std::vector<TileEdit> tileEdits;        // Trocas de textura de tiles ainda não confirmadas pela GPU
+};
+
+// Medidas da thread de desenho, lidas pela thread principal para o título da janela
+struct RenderFrameStats {
+    size_t itemCount = 0;                   // Itens na fila de desenho
+    size_t drawCount = 0;                   // Chamadas de desenho de sprites
+    int stateChangesIssued = 0;             // Trocas de estado enviadas ao driver
+    int stateChangesElided = 0;             // Trocas de estado descartadas pelo RenderState
+    size_t pendingTextures = 0;             // Texturas ainda em carregamento
+    double idleFraction = 0.0;              // Fração do tempo dormindo no limite de quadros
+    double renderTime = 0.0;                // Duração do último frame desenhado em segundos, com a troca de buffers
+    uint64_t framesRendered = 0;            // Frames desenhados desde o início
+};
+
+// Classe que desenha em uma thread própria, dona do contexto OpenGL
+// A simulação preenche um FramePacket e o publica; a thread de desenho pega sempre o mais recente. Os três
+// pacotes giram por uma troca atômica de índices (triple buffering): a simulação nunca espera a GPU para escrever e
+// a thread de desenho nunca lê um pacote pela metade. Se a simulação publicar dois pacotes antes de um desenho,
+// o mais antigo é descartado; por isso tudo que não pode se perder (trocas de tiles) é repetido até ser confirmado
+class RenderThread {
+public:
+    // Função que desenha um pacote; roda na thread de desenho e preenche as medidas do frame
+    typedef std::function<void(const FramePacket& packet, RenderFrameStats& stats)> RenderFunction;
+
+    // Construtor: solta o contexto da janela da thread atual e inicia a thread de desenho, que o torna atual
+    RenderThread(GLFWwindow* window, RenderFunction render);
+
+    // Para a thread de desenho e devolve o contexto para a thread que destrói o objeto
+    ~RenderThread();
+
+    // A thread de desenho guarda 'this', por isso o objeto não pode ser copiado
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Retorna o pacote que a simulação pode preencher, com os vetores vazios (a memória é reaproveitada)
+    FramePacket& beginPacket();
+
+    // Publica o pacote preenchido, que passa a ser o próximo a ser desenhado
+    void publish();
+
+    // Espera a thread de desenho pegar o último pacote publicado, por no máximo 'timeout' segundos
+    // Mantém a simulação no máximo um frame à frente do desenho sem travá-la quando a GPU demora
+    void waitForConsumption(double timeout);
+
+    // Retorna as medidas do último frame desenhado
+    RenderFrameStats getStats();
+
+private:
+    static const uint32_t INDEX_MASK = 3;   // Índice do pacote no valor compartilhado
+    static const uint32_t FRESH_BIT = 4;    // Pacote compartilhado ainda não lido pela thread de desenho
+
+    // Laço da thread de desenho
+    void renderLoop();
+
+    GLFWwindow* window;                     // Janela cujo contexto a thread de desenho usa
+    RenderFunction render;                  // Desenho de um pacote
+    FramePacket packets[3];                 // Pacotes em rodízio
+    uint32_t writeIndex;                    // Pacote da simulação
+    uint32_t readIndex;                     // Pacote da thread de desenho
+    std::atomic<uint32_t> shared;           // Pacote trocado entre as duas (índice | FRESH_BIT)
+    std::atomic<bool> stopping;             // Pede o fim da thread de desenho
+
+    std::mutex wakeMutex;                   // Só serve às esperas; os pacotes não dependem dele
+    std::condition_variable wakeCondition;  // Acorda quem espera um pacote novo ou o consumo do último
+
+    std::mutex statsMutex;                  // Protege stats
+    RenderFrameStats stats;                 // Medidas do último frame desenhado
+
+    std::thread thread;                     // Thread de desenho
+};
+
+#endif
@@ -4,6 +4,8 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 //GLAD
 #include <glad/glad.h>
@@ -11,11 +13,29 @@
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Filtro de trocas de estado
+#include "RenderState.h"
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
 using namespace std;
 
+// Typed handle to a uniform location, resolved once after the program links
+// Hot uniforms (set every draw) should be looked up once and set through Shader::set
+template <typename T>
+struct Uniform
+{
+	GLint location = -1;
+};
+
 class Shader
 {
 public:
+	// Binding point of the std140 "Camera" block (projection and view) shared by every program
+	static const GLuint CAMERA_BLOCK_BINDING = 0;
+
 	GLuint ID;
 	// Constructor generates the shader on the fly
 	Shader(const GLchar* vertexPath, const GLchar* fragmentPath)
@@ -91,49 +111,131 @@ public:
 		// Delete the shaders as they're linked into our program now and no longer necessery
 		glDeleteShader(vertex);
 		glDeleteShader(fragment);
-
+		// Resolve every uniform location and the camera block binding once, now that the program is linked
+		cacheUniformLocations();
+		GLuint cameraBlock = glGetUniformBlockIndex(this->ID, "Camera");
+		if (cameraBlock != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(this->ID, cameraBlock, CAMERA_BLOCK_BINDING);
+		}
 	}
-	// Uses the current shader
+	// Uses the current shader (skipped if it is already in use)
 	void Use()
 	{
-		glUseProgram(this->ID);
+		RenderState::useProgram(this->ID);
+	}
+
+	// Returns the cached location of a uniform, or -1 if the program has no active uniform with that name
+	GLint getUniformLocation(const std::string& name) const
+	{
+		std::unordered_map<std::string, GLint>::const_iterator it = uniformLocations.find(name);
+		return it != uniformLocations.end() ? it->second : -1;
+	}
+
+	// Returns a typed handle for a hot uniform
+	template <typename T>
+	Uniform<T> getUniform(const std::string& name) const
+	{
+		Uniform<T> uniform;
+		uniform.location = getUniformLocation(name);
+		return uniform;
+	}
+
+	// Typed setters: no string hashing and no driver lookup (the program must be in use)
+	void set(Uniform<int> uniform, int value) const
+	{
+		glUniform1i(uniform.location, value);
 	}
 
+	void set(Uniform<float> uniform, float value) const
+	{
+		glUniform1f(uniform.location, value);
+	}
+
+	void set(Uniform<glm::vec2> uniform, const glm::vec2& value) const
+	{
+		glUniform2fv(uniform.location, 1, glm::value_ptr(value));
+	}
+
+	void set(Uniform<glm::vec4> uniform, const glm::vec4& value) const
+	{
+		glUniform4fv(uniform.location, 1, glm::value_ptr(value));
+	}
+
+	void set(Uniform<glm::mat4> uniform, const glm::mat4& value) const
+	{
+		glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	// Name-based setters use the location cache; prefer typed handles for uniforms set every frame
 	void setBool(const std::string& name, bool value) const
 	{
-		glUniform1i(glGetUniformLocation(this->ID, name.c_str()), (int)value);
+		glUniform1i(getUniformLocation(name), (int)value);
 	}
 	// ------------------------------------------------------------------------
 	void setInt(const std::string& name, int value) const
 	{
-		glUniform1i(glGetUniformLocation(this->ID, name.c_str()), value);
+		glUniform1i(getUniformLocation(name), value);
 	}
 	// ------------------------------------------------------------------------
 	void setFloat(const std::string& name, float value) const
 	{
-		glUniform1f(glGetUniformLocation(this->ID, name.c_str()), value);
+		glUniform1f(getUniformLocation(name), value);
 	}
 
 	// ------------------------------------------------------------------------
 	void setVec2(const std::string& name, float v1, float v2) const
 	{
-		glUniform2f(glGetUniformLocation(this->ID, name.c_str()), v1, v2);
+		glUniform2f(getUniformLocation(name), v1, v2);
 	}
 
 	// ------------------------------------------------------------------------
 	void setVec3(const std::string& name, float v1, float v2, float v3) const
 	{
-		glUniform3f(glGetUniformLocation(this->ID, name.c_str()), v1, v2, v3);
+		glUniform3f(getUniformLocation(name), v1, v2, v3);
 	}
 
 	void setVec4(const std::string& name, float v1, float v2, float v3, float v4) const
 	{
-		glUniform4f(glGetUniformLocation(this->ID, name.c_str()), v1, v2, v3, v4);
+		glUniform4f(getUniformLocation(name), v1, v2, v3, v4);
 	}
 
 	void setMat4(const std::string& name, float* v) const
 	{
-		glUniformMatrix4fv(glGetUniformLocation(this->ID, name.c_str()), 1, GL_FALSE, v);
+		glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, v);
+	}
+
+private:
+	// Locations of the active uniforms, filled once after linking
+	std::unordered_map<std::string, GLint> uniformLocations;
+
+	// Queries every active uniform of the program and stores its location
+	void cacheUniformLocations()
+	{
+		GLint count = 0, maxLength = 0;
+		glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+		std::vector<GLchar> buffer(maxLength > 0 ? maxLength : 1);
+		for (GLint i = 0; i < count; ++i)
+		{
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(this->ID, i, static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data());
+			std::string name(buffer.data(), length);
+			// Uniforms inside blocks have no location
+			GLint location = glGetUniformLocation(this->ID, name.c_str());
+			if (location < 0)
+			{
+				continue;
+			}
+			uniformLocations[name] = location;
+			// Arrays are reported as "name[0]"; the plain name refers to the same location
+			if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+			{
+				uniformLocations[name.substr(0, name.size() - 3)] = location;
+			}
+		}
 	}
 };
 
@@ -0,0 +1,59 @@
+#include "SharedQuad.h"
+#include "RenderState.h"
+#include <GLFW/glfw3.h>
+
+const GLsizei SharedQuad::INDEX_COUNT;
+const GLenum SharedQuad::INDEX_TYPE;
+
+GLuint SharedQuad::vertexBuffer = 0;
+GLuint SharedQuad::indexBuffer = 0;
+int SharedQuad::users = 0;
+
+// Função que cria os buffers do quad no primeiro usuário
+void SharedQuad::acquire() {
+    if (users++ > 0) {
+        return;
+    }
+
+    // Cantos na ordem inferior esquerdo, inferior direito, superior direito, superior esquerdo
+    const GLshort corners[] = {
+        -1, -1,
+         1, -1,
+         1,  1,
+        -1,  1
+    };
+    const GLubyte indices[] = { 0, 1, 2, 0, 2, 3 };
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // O índice fica associado ao VAO vinculado, por isso nenhum VAO pode estar vinculado aqui
+    RenderState::bindVertexArray(0);
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Função que libera os buffers quando o último usuário sai
+void SharedQuad::release() {
+    if (users == 0 || --users > 0) {
+        return;
+    }
+    if (glfwGetCurrentContext() != nullptr) {
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteBuffers(1, &indexBuffer);
+    }
+    vertexBuffer = indexBuffer = 0;
+}
+
+// Função que associa o quad ao VAO vinculado
+void SharedQuad::attach() {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, 2 * sizeof(GLshort), (GLvoid*)0);   // Canto do quad
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);                                 // Índices do quad (ficam associados ao VAO)
+}
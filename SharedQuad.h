@@ -0,0 +1,30 @@
+#ifndef SHAREDQUAD_H
+#define SHAREDQUAD_H
+
+#include <glad/glad.h>
+
+// Quad unitário compartilhado por todos os desenhos instanciados (sprites, tiles e chunks)
+// Um único par de buffers na GPU: 4 cantos de 4 bytes (GLshort x2, -1 ou 1) e 6 índices GLubyte para os
+// dois triângulos, desenhados com glDrawElementsInstanced(GL_TRIANGLES, INDEX_COUNT, INDEX_TYPE, 0, n).
+// Os shaders recebem o canto no atributo 0 e usam quadCorner * 0.5 (-0.5 a 0.5)
+class SharedQuad {
+public:
+    static const GLsizei INDEX_COUNT = 6;               // Índices dos dois triângulos
+    static const GLenum INDEX_TYPE = GL_UNSIGNED_BYTE;  // Tipo dos índices
+
+    // Registra um usuário do quad, criando os buffers no primeiro
+    static void acquire();
+
+    // Libera um usuário; os buffers são excluídos com o último, se ainda houver um contexto OpenGL ativo
+    static void release();
+
+    // Associa o quad ao VAO vinculado: canto no atributo 0 e índices no GL_ELEMENT_ARRAY_BUFFER
+    static void attach();
+
+private:
+    static GLuint vertexBuffer;     // Cantos do quad
+    static GLuint indexBuffer;      // Índices do quad
+    static int users;               // Quantidade de acquire() sem release()
+};
+
+#endif
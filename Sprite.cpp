@@ -1,69 +1,103 @@
 #include "Sprite.h"
-#include <stb_image.h>
 #include <iostream>
+#include <cmath>
 
 /* Construtor da Classe Sprite
-Recebe Shader, TextureID, posio, escala e rotao como parmetros
-Chama as funes setupGeometry() e updateModeMatrix() por padro
+Recebe Shader, TextureID, posição, escala e rotação como parâmetros
+Registra a transformação no TransformSystem; a geometria (quad unitário) é compartilhada pela RenderQueue
 */
 
 Sprite::Sprite(Shader& shader, const std::string& texturePath, glm::vec3 position, glm::vec3 tilePosition, glm::vec3 scale, float rotation)
     : shader(shader), position(position), tilePosition(tilePosition), scale(scale), rotation(rotation),
-    timeAccumulator(0.0f), currentFrameX(0), currentFrameY(0) {
-    textureID = loadTexture(texturePath);
-    setupGeometry();
-    updateModelMatrix();
+    uvRect(0.0f, 0.0f, 1.0f, 1.0f), timeAccumulator(0.0f), currentFrameX(0), currentFrameY(0) {
+    // A imagem pode estar em um atlas; nesse caso os frames são convertidos para a região dela no submit()
+    TextureRegion region = TextureCache::loadRegion(texturePath);
+    texture = region.texture;
+    textureRect = region.uvRect;
+    transform = TransformSystem::create(glm::vec2(position), glm::vec2(scale), rotation);
 }
 
-// Construtor de movimento
+// Construtor de movimento: a transformação passa para o novo sprite
 Sprite::Sprite(Sprite&& other) noexcept
-    : shader(other.shader), textureID(other.textureID), position(other.position), tilePosition(other.tilePosition),
-    scale(other.scale), rotation(other.rotation), VAO(other.VAO), VBO(other.VBO), modelMatrix(other.modelMatrix) {
-    other.textureID = 0;
-    other.VAO = 0;
-    other.VBO = 0;
+    : shader(other.shader), texture(std::move(other.texture)), textureRect(other.textureRect), position(other.position), tilePosition(other.tilePosition),
+    scale(other.scale), rotation(other.rotation), transform(other.transform), uvRect(other.uvRect),
+    timeAccumulator(other.timeAccumulator), currentFrameX(other.currentFrameX), currentFrameY(other.currentFrameY) {
+    other.transform = -1;
+}
+
+// Destrutor da classe Sprite
+Sprite::~Sprite() {
+    TransformSystem::destroy(transform);
 }
 
 // Copia as propriedades de um Sprite para o outro
 Sprite& Sprite::operator=(Sprite&& other) noexcept {
     if (this != &other) {
         shader = other.shader;
-        textureID = other.textureID;
+        texture = std::move(other.texture);
+        textureRect = other.textureRect;
         position = other.position;
         tilePosition = other.tilePosition;
         scale = other.scale;
         rotation = other.rotation;
-        VAO = other.VAO;
-        VBO = other.VBO;
-        modelMatrix = other.modelMatrix;
-
-        other.textureID = 0;
-        other.VAO = 0;
-        other.VBO = 0;
+        TransformSystem::destroy(transform);
+        transform = other.transform;
+        other.transform = -1;
+        uvRect = other.uvRect;
+        timeAccumulator = other.timeAccumulator;
+        currentFrameX = other.currentFrameX;
+        currentFrameY = other.currentFrameY;
     }
     return *this;
 }
 
-// Funo para atualizar o sprite
-// Chama a funo updateModelMatrix para recalcular a matriz de modelo
+// Função para atualizar o sprite
+// Só guarda os valores; um sprite parado não marca a transformação como suja e não é recalculado
 void Sprite::updateSprite() {
-    updateModelMatrix();
+    TransformSystem::set(transform, glm::vec2(position), glm::vec2(scale), rotation);
 }
 
-// Funo para renderizar o sprite
-// Configura o shader, textura, e desenha o sprite na tela
-void Sprite::draw() const {
-    shader.Use();
-    shader.setMat4("model", const_cast<float*>(glm::value_ptr(modelMatrix)));  // Envia a matriz de modelo ao shader
-    glActiveTexture(GL_TEXTURE0);                                              // Ativa a unidade de textura 0
-    glBindTexture(GL_TEXTURE_2D, textureID);                                   // Vincula a textura ao alvo de textura 2D
-    glBindVertexArray(VAO);                                                    // Vincula o Vertex Array Object (VAO)
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);                                       // Desenha os vrtices do sprite como um tringulo fan
-    glBindVertexArray(0);                                                      // Desassocia o VAO
+// Função para enviar o sprite à fila de desenho
+// O desenho acontece no RenderQueue::flush(), agrupado com os outros sprites que usam o mesmo shader e a mesma textura
+void Sprite::submit(RenderQueue& queue, uint8_t layer) const {
+    queue.submit(makeDraw(layer));
 }
 
+// Função que monta o desenho do sprite
+// No mundo, a profundidade é a da diagonal do tile do sprite, logo depois dos tiles dela (IsoDepth.h); nas outras
+// camadas vem da altura na tela
+SpriteDraw Sprite::makeDraw(uint8_t layer) const {
+    uint32_t depth;
+    float z;
+    if (layer == RENDER_LAYER_WORLD) {
+        depth = isoPainterDepth(getDepthDiagonal(), ISO_SLOT_ENTITIES);
+        z = isoDepthZ(depth);
+    }
+    else {
+        depth = RenderQueue::depthFromY(position.y);
+        z = 1.0f;     // Fora do mundo o sprite fica na frente de tudo
+    }
+
+    // Frame na spritesheet convertido para a área dela na textura (atlas)
+    glm::vec4 frame(glm::vec2(textureRect) + glm::vec2(uvRect) * glm::vec2(textureRect.z, textureRect.w),
+        uvRect.z * textureRect.z, uvRect.w * textureRect.w);
+
+    SpriteDraw draw;
+    draw.layer = layer;
+    draw.depth = depth;
+    draw.program = shader.ID;
+    draw.texture = texture.get();
+    draw.instance.set(getModelMatrix(), frame, z);
+    return draw;
+}
 
-// Funo para atualizar a textura de forma a animar o Sprite
+// Função que retorna a diagonal do tile do sprite
+int Sprite::getDepthDiagonal() const {
+    return static_cast<int>(tilePosition.x + tilePosition.y);
+}
+
+
+// Função para atualizar a textura de forma a animar o Sprite
 void Sprite::updateTextureCoordsAnimated(int columns, int rows, float deltaTime, int startFrameX, int startFrameY, int endFrameX, int endFrameY) {
     // Calculate the total number of frames in the animation
     int totalFrames = (endFrameY - startFrameY) * columns + (endFrameX - startFrameX) + 1;
@@ -94,23 +128,11 @@ void Sprite::updateTextureCoordsAnimated(int columns, int rows, float deltaTime,
     float offsetS = currentFrameX * ds;
     float offsetT = currentFrameY * dt;
 
-    GLfloat vertices[] = {
-        //      Coordinates       /       Colors        /    TexCoord
-            -0.5f, -0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS, offsetT,             // Lower left corner
-             0.5f, -0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS + ds, offsetT,        // Lower right corner
-             0.5f,  0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS + ds, offsetT + dt,   // Upper right corner
-            -0.5f,  0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS, offsetT + dt         // Upper left corner
-    };
-
-    // Update the vertex buffer with the new data
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // Frame atual na spritesheet, lido pelo shader a partir da instância do sprite
+    uvRect = glm::vec4(offsetS, offsetT, ds, dt);
 }
 
-// Funo para atualizar a textura 
+// Função para atualizar a textura 
 void Sprite::updateTextureCoordsStatic(int columns, int rows, int frameX, int frameY) {
     // Calculate texture offsets (s and t)
     float ds = 1.0f / columns;
@@ -120,39 +142,30 @@ void Sprite::updateTextureCoordsStatic(int columns, int rows, int frameX, int fr
     float offsetS = frameX * ds;
     float offsetT = frameY * dt;
 
-    GLfloat vertices[] = {
-        //      Coordinates       /       Colors        /    TexCoord
-            -0.5f, -0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS, offsetT,             // Lower left corner
-             0.5f, -0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS + ds, offsetT,        // Lower right corner
-             0.5f,  0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS + ds, offsetT + dt,   // Upper right corner
-            -0.5f,  0.5f, 0.0f,      1.0f, 1.0f, 1.0f,       offsetS, offsetT + dt         // Upper left corner
-    };
-
-    // Update the vertex buffer with the new data
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // Frame atual na spritesheet, lido pelo shader a partir da instância do sprite
+    uvRect = glm::vec4(offsetS, offsetT, ds, dt);
 }
 
-// Funo para atualizar o sprite
-// Calcula a matriz de modelo com base na posio, rotao e escala do sprite
-void Sprite::updateModelMatrix() {
-    modelMatrix = glm::mat4(1.0f);                                                                   // Inicializa a matriz de modelo como a matriz identidade
-    modelMatrix = glm::translate(modelMatrix, position);                                             // Aplica a translao
-    modelMatrix = glm::rotate(modelMatrix, glm::radians(rotation), glm::vec3(0.0, 0.0, 1.0));        // Aplica a rotao
-    modelMatrix = glm::scale(modelMatrix, scale);                                                    // Aplica a escala
+// Função para retornar a ModelMatrix
+Affine2D Sprite::getModelMatrix() const {
+    return TransformSystem::getMatrix(transform);
 }
 
-// Funo para retornar a ModelMatrix
-glm::mat4 Sprite::getModelMatrix() const {
-    return modelMatrix;
+// Função que testa se o sprite aparece na tela
+// Os cantos do quad compartilhado vão de -1 a 1, mas o tex.vs os multiplica por 0.5, então o sprite ocupa -0.5 a 0.5
+// nos dois eixos: a meia largura do retângulo envolvente é (|a| + |b|) / 2 e a meia altura (|c| + |d|) / 2, valendo
+// também para sprites girados
+bool Sprite::isVisible(const glm::vec3& cameraPos, float screenWidth, float screenHeight) const {
+    Affine2D matrix = getModelMatrix();
+    float halfWidth = (std::abs(matrix.a) + std::abs(matrix.b)) * 0.5f;
+    float halfHeight = (std::abs(matrix.c) + std::abs(matrix.d)) * 0.5f;
+    return matrix.tx + halfWidth >= cameraPos.x && matrix.tx - halfWidth <= cameraPos.x + screenWidth
+        && matrix.ty + halfHeight >= cameraPos.y && matrix.ty - halfHeight <= cameraPos.y + screenHeight;
 }
 
-// Funo para retornar o ID da textura atribuda
+// Função para retornar o ID da textura atribuída
 GLuint Sprite::getTextureID() const {
-    return textureID;
+    return texture ? texture->getID() : 0;
 }
 
 glm::vec3 Sprite::getPosition() const {
@@ -166,83 +179,3 @@ glm::vec3 Sprite::getTilePosition() const {
 void Sprite::setTilePosition(glm::vec3 new_position) {
     this->tilePosition = new_position; 
 }
-
-// Funo para VAO e VBO define os atributos de posio, cor e coordenadas da textura
-// Define os atributos de posio, cor e coordenadas de textura dos vrtices e os armazena em buffers
-void Sprite::setupGeometry() {
-    GLfloat vertices[] = {
-        //      Coordenadas        /       Cores          /    TexCoord
-            -0.5f, -0.5f, 0.0f,      1.0f, 0.0f, 0.0f,       0.0f, 0.0f,     // Lower Left corner
-             0.5f, -0.5f, 0.0f,      0.0f, 1.0f, 0.0f,       1.0f, 0.0f,     // Lower right corner
-             0.5f, 0.5f, 0.0f,       0.0f, 0.0f, 1.0f,       1.0f, 1.0f,     // Upper right corner
-            -0.5f, 0.5f, 0.0f,       1.0f, 1.0f, 0.0f,       0.0f, 1.0f      // Upper left corner
-    };
-
-    glGenBuffers(1, &VBO);                                                              // Gera um buffer de vrtices
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);                                                 // Associa o buffer ao alvo de buffer de array
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);          // Envia os dados de vrtices para o buffer
-
-    glGenVertexArrays(1, &VAO);                                                         // Gera um Vertex Array Object (VAO)
-    glBindVertexArray(VAO);                                                             // Vincula o VAO
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (GLvoid*)0);   // Posio dos vrtices
-    glEnableVertexAttribArray(0);                                                       // Habilita o atributo de posio
-
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));   // Cores dos vrtices
-    glEnableVertexAttribArray(1);                                                                           // Habilita o atributo de cor
-
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (GLvoid*)(6 * sizeof(GLfloat)));   // Coordenadas de textura
-    glEnableVertexAttribArray(2);                                                       // Habilita o atributo de coordenadas de textura
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);                                                   // Desassocia o buffer de vrtices
-    glBindVertexArray(0);                                                               // Desassocia o VAO
-}
-
-// Funo para carregar a textura e retornar o ID da textura
-GLuint Sprite::loadTexture(const std::string& texturePath) {
-    GLuint texID;
-
-    // Gera o identificador da textura na memria
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    // Configurao do parmetro WRAPPING nas coords s e t
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    // Configurao do parmetro FILTERING na minificao e magnificao da textura
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Atributos bsicos da imagem, largura, altura e nmero de canais de cores
-    int width, height, nrChannels;
-    // Habilita um flipagem vertical no carregamento da imagem
-    stbi_set_flip_vertically_on_load(true);
-    // Imagem
-    unsigned char* data = stbi_load(texturePath.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data) {
-        if (nrChannels == 3) { //jpg, bmp
-            // Texturiza a imagem com o RGB
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        else { //png
-         // Texturiza a imagem com o RGBA
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        }
-        glGenerateMipmap(GL_TEXTURE_2D);
-        // Permite o PNG mesclar com o fundo caso tenha fundo nulo
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    }
-    else {
-        std::cerr << "Failed to load texture" << std::endl;
-    }
-
-    // Libera os dados da imagem
-    stbi_image_free(data);
-    // Desvincula a textura
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    return texID;
-}
\ No newline at end of file
@@ -5,74 +5,84 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "Shader.h"
+#include "Texture.h"
+#include "RenderQueue.h"
+#include "IsoDepth.h"
+#include "TransformSystem.h"
 
 class Sprite { 
 
 public:
-    // Construtor: inicializa o sprite com o shader, ID da textura, posio, posio em 2.5D, escala e rotao
+    // Construtor: inicializa o sprite com o shader, ID da textura, posição, posição em 2.5D, escala e rotação
     Sprite(Shader& shader, const std::string& texturePath, glm::vec3 position, glm::vec3 tilePosition, glm::vec3 scale, float rotation);
 
-    // Deleta a cpia do construtor e aloca para outro Sprite
+    // Deleta a cópia do construtor e aloca para outro Sprite
     Sprite(const Sprite&) = delete;
     Sprite& operator=(const Sprite&) = delete;
 
-    // Define o construtor de transferncia e aloca para outro Sprite
+    // Define o construtor de transferência e aloca para outro Sprite
     Sprite(Sprite&& other) noexcept;
     Sprite& operator=(Sprite&& other) noexcept;
 
-    // Atualiza a matriz de modelo do sprite
+    // Destrutor virtual: o CharacterController herda de Sprite
+    // Remove a transformação do sprite do TransformSystem
+    virtual ~Sprite();
+
+    // Informa a posição, a escala e a rotação atuais ao TransformSystem; a matriz só é recalculada no
+    // TransformSystem::update() e somente se algum valor mudou
     void updateSprite();
 
-    // Renderiza o sprite na tela
-    void draw() const;
+    // Envia o sprite para a fila de desenho do frame na camada informada
+    void submit(RenderQueue& queue, uint8_t layer = RENDER_LAYER_WORLD) const;
+
+    // Monta o desenho do sprite sem chamar a OpenGL, para um frame preparado fora da thread de desenho
+    SpriteDraw makeDraw(uint8_t layer = RENDER_LAYER_WORLD) const;
 
-    // Atualiza o estado da textura em animao
+    // Retorna a diagonal (x + y) usada para intercalar o sprite com os tiles na ordem de pintura
+    virtual int getDepthDiagonal() const;
+
+    // Atualiza o estado da textura em animação
     void updateTextureCoordsAnimated(int columns, int rows, float deltaTime, int startFrameX, int startFrameY, int endFrameX, int endFrameY);
 
-    // Atualiza o estado da textura esttica
+    // Atualiza o estado da textura estática
     void updateTextureCoordsStatic(int columns, int rows, int frameX, int frameY);
 
-    // Retorna a matriz de modelo atual do sprite
-    glm::mat4 getModelMatrix() const;
+    // Retorna a matriz de modelo do sprite calculada no último TransformSystem::update()
+    Affine2D getModelMatrix() const;
+
+    // Retorna se o quad do sprite, com a matriz do último TransformSystem::update(), cruza a tela
+    // (cameraPos é o canto inferior esquerdo da tela no mundo); só lê dados, pode rodar em qualquer thread
+    bool isVisible(const glm::vec3& cameraPos, float screenWidth, float screenHeight) const;
 
-    // Retorna a posio do Sprite
+    // Retorna a posição do Sprite
     glm::vec3 getPosition() const; 
 
-    // Retorna a posio do Sprite em relao aos tiles
+    // Retorna a posição do Sprite em relação aos tiles
     glm::vec3 getTilePosition() const;
 
     // Retorna o ID da textura associada ao sprite
     GLuint getTextureID() const;
 
-    // Redefine a varivel tilePosition
+    // Redefine a variável tilePosition
     void setTilePosition(glm::vec3 new_position);
 
 protected:
-    // Variveis de renderizao do objeto Sprite
-    Shader& shader;          // Referncia ao shader usado pelo sprite
-    GLuint textureID;        // ID da textura associada ao sprite
+    // Variáveis de renderização do objeto Sprite
+    Shader& shader;          // Referência ao shader usado pelo sprite
+    TextureHandle texture;   // Textura compartilhada associada ao sprite (a página do atlas, se a imagem foi empacotada)
+    glm::vec4 textureRect;   // Área da imagem do sprite na textura: offset (xy) e tamanho (zw)
     std::string texturePath; // Store texture path for copying
-    glm::vec3 position;      // Posio do sprite
-    glm::vec3 tilePosition;  // Posio do sprite em relao aos tiles
+    glm::vec3 position;      // Posição do sprite
+    glm::vec3 tilePosition;  // Posição do sprite em relação aos tiles
     glm::vec3 scale;         // Escala do sprite
-    float rotation;          // Rotao do sprite
-    GLuint VAO;              // Vertex Array Object do sprite
-    GLuint VBO;              // Vertex Buffer Object do sprite
-    glm::mat4 modelMatrix;   // Matriz de modelo do sprite
+    float rotation;          // Rotação do sprite
+    int transform;           // Identificador da transformação no TransformSystem (-1 depois de movido)
+    glm::vec4 uvRect;        // Frame atual na spritesheet: offset (xy) e tamanho (zw)
 
     float timeAccumulator;
     int currentFrameX;
     int currentFrameY;
 
-    // Atualiza a matriz de modelo do sprite com base na posio, rotao e escala
-    void updateModelMatrix();
-
-    // Configura a geometria do sprite definindo os atributos de vrtices
-    void setupGeometry();
-
-    // Carrega a textura e retorna um ID da textura
-    GLuint loadTexture(const std::string& texturePath);
-
 };
 
 #endif
@@ -0,0 +1,318 @@
+#include "Texture.h"
+#include "RenderState.h"
+#include "AtlasManifest.h"
+#include <GLFW/glfw3.h>
+#include "DecodedImage.h"
+#include "TextureStreamer.h"
+#include <iostream>
+
+std::unordered_map<std::string, std::weak_ptr<Texture>> TextureCache::textures;
+std::unordered_map<std::string, TextureCache::AtlasEntry> TextureCache::atlasEntries;
+std::unique_ptr<TextureStreamer> TextureCache::streamer;
+GLuint TextureCache::placeholder = 0;
+
+// Construtor da classe Texture
+Texture::Texture(GLuint id, int width, int height, GLenum target, int layers)
+    : id(id), width(width), height(height), target(target), layers(layers), resident(true) {
+}
+
+// Construtor de uma textura em carregamento
+Texture::Texture(GLuint placeholderID)
+    : id(placeholderID), width(0), height(0), target(GL_TEXTURE_2D), layers(1), resident(false) {
+}
+
+// Destrutor: libera a textura somente se ainda houver um contexto OpenGL ativo
+Texture::~Texture() {
+    if (resident && id != 0 && glfwGetCurrentContext() != nullptr) {
+        glDeleteTextures(1, &id);
+        RenderState::textureDeleted(id);
+    }
+}
+
+// Função para retornar o ID da textura
+GLuint Texture::getID() const {
+    return id;
+}
+
+// Função para retornar a largura da textura
+int Texture::getWidth() const {
+    return width;
+}
+
+// Função para retornar a altura da textura
+int Texture::getHeight() const {
+    return height;
+}
+
+// Função para retornar o tipo da textura
+GLenum Texture::getTarget() const {
+    return target;
+}
+
+// Função para retornar a quantidade de camadas
+int Texture::getLayers() const {
+    return layers;
+}
+
+// Função que vincula a textura
+void Texture::bind(GLuint unit) const {
+    RenderState::bindTexture(id, unit, target);
+}
+
+// Função que indica se a imagem já está na GPU
+bool Texture::isResident() const {
+    return resident;
+}
+
+// Função que troca o placeholder pela textura completa
+// Os sprites leem o ID no submit, então passam a usar a textura nova no mesmo frame
+void Texture::setResident(GLuint textureID, int textureWidth, int textureHeight) {
+    id = textureID;
+    width = textureWidth;
+    height = textureHeight;
+    resident = true;
+}
+
+// Função para buscar uma textura no cache ou carregá-la caso nenhum usuário a tenha em uso
+TextureHandle TextureCache::load(const std::string& texturePath) {
+    auto it = textures.find(texturePath);
+    if (it != textures.end()) {
+        if (TextureHandle texture = it->second.lock()) {
+            return texture;
+        }
+    }
+
+    TextureHandle texture;
+    if (streamer) {
+        texture = std::make_shared<Texture>(placeholderID());
+        streamer->request(texturePath, texture);
+    }
+    else {
+        int width = 0, height = 0;
+        GLuint texID = loadFromFile(texturePath, width, height);
+        texture = std::make_shared<Texture>(texID, width, height);
+    }
+    textures[texturePath] = texture;
+    return texture;
+}
+
+// Função que liga o carregamento assíncrono
+void TextureCache::startStreaming(int workerCount) {
+    if (!streamer) {
+        streamer.reset(new TextureStreamer(workerCount));
+    }
+}
+
+// Função que desliga o carregamento assíncrono e libera o placeholder
+// As texturas que ainda o usam continuam válidas, mas passam a vincular o ID 0
+void TextureCache::stopStreaming() {
+    streamer.reset();
+    if (placeholder != 0 && glfwGetCurrentContext() != nullptr) {
+        glDeleteTextures(1, &placeholder);
+        RenderState::textureDeleted(placeholder);
+    }
+    placeholder = 0;
+}
+
+// Função chamada a cada frame para avançar o carregamento assíncrono
+void TextureCache::update(size_t byteBudget) {
+    if (streamer) {
+        streamer->update(byteBudget);
+    }
+}
+
+// Função para retornar a quantidade de texturas em carregamento
+size_t TextureCache::getPendingCount() {
+    return streamer ? streamer->getPendingCount() : 0;
+}
+
+// Função que registra as regiões de um atlas
+// As páginas só são carregadas quando alguma região delas é pedida pelo loadRegion
+// A imagem é invertida no carregamento (stbi_set_flip_vertically_on_load), então o v da região é medido a partir
+// da borda inferior da página
+bool TextureCache::loadAtlas(const std::string& manifestPath) {
+    AtlasManifest manifest;
+    if (!loadAtlasManifest(manifestPath, manifest)) {
+        return false;
+    }
+    for (const AtlasRegion& region : manifest.regions) {
+        const AtlasPage& page = manifest.pages[region.page];
+        float width = static_cast<float>(page.width);
+        float height = static_cast<float>(page.height);
+        glm::vec4 uvRect(region.x / width, (page.height - region.y - region.height) / height,
+            region.width / width, region.height / height);
+        atlasEntries[region.name] = AtlasEntry{ page.path, uvRect };
+    }
+    return true;
+}
+
+// Função que retorna a textura e a área de uma imagem, usando o atlas quando ela foi empacotada
+TextureRegion TextureCache::loadRegion(const std::string& texturePath) {
+    TextureRegion region;
+    auto it = atlasEntries.find(texturePath);
+    if (it != atlasEntries.end()) {
+        region.texture = load(it->second.pagePath);
+        region.uvRect = it->second.uvRect;
+    }
+    else {
+        region.texture = load(texturePath);
+    }
+    return region;
+}
+
+// Função para buscar uma spritesheet fatiada no cache ou carregá-la
+// A chave inclui o grid, assim a mesma imagem pode existir como textura 2D (atlas) e como textura array
+TextureHandle TextureCache::loadArray(const std::string& texturePath, int columns, int rows) {
+    std::string key = texturePath + "#array" + std::to_string(columns) + "x" + std::to_string(rows);
+    auto it = textures.find(key);
+    if (it != textures.end()) {
+        if (TextureHandle texture = it->second.lock()) {
+            return texture;
+        }
+    }
+
+    int width = 0, height = 0;
+    GLuint texID = loadArrayFromFile(texturePath, columns, rows, width, height);
+    TextureHandle texture = std::make_shared<Texture>(texID, width, height, GL_TEXTURE_2D_ARRAY, columns * rows);
+    textures[key] = texture;
+    return texture;
+}
+
+// Função para retornar a quantidade de texturas vivas no cache
+size_t TextureCache::size() {
+    size_t count = 0;
+    for (const auto& entry : textures) {
+        if (!entry.second.expired()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Função que cria uma textura 2D vazia e vinculada
+GLuint TextureCache::createTexture2D() {
+    GLuint texID;
+
+    // Gera o identificador da textura na memória
+    glGenTextures(1, &texID);
+    RenderState::bindTexture(texID);
+
+    // Configuração do parâmetro WRAPPING nas coords s e t
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    // Configuração do parâmetro FILTERING na minificação e magnificação da textura
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return texID;
+}
+
+// Função que cria o placeholder: um pixel cinza semitransparente, que mostra onde está o sprite sem chamar atenção
+// No modo com depth buffer o corte de transparência (0.5) o descarta, e o objeto só aparece quando carregar
+GLuint TextureCache::placeholderID() {
+    if (placeholder == 0) {
+        const unsigned char pixel[4] = { 128, 128, 128, 96 };
+        placeholder = createTexture2D();
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+        // O placeholder também mescla com o fundo
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    return placeholder;
+}
+
+// Função para carregar a textura e retornar o ID da textura
+GLuint TextureCache::loadFromFile(const std::string& texturePath, int& width, int& height) {
+    GLuint texID = createTexture2D();
+
+    // Imagem já invertida e com as mipmaps: vem do cache (<imagem>.gbtex) mapeado em memória, ou é
+    // decodificada pelo stb_image e gravada no cache quando ele não existe ou está desatualizado
+    DecodedImage image;
+    if (image.load(texturePath)) {
+        width = image.getWidth();
+        height = image.getHeight();
+        uploadLevels(GL_TEXTURE_2D, image);
+
+        // Permite o PNG mesclar com o fundo caso tenha fundo nulo
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else {
+        width = height = 0;
+    }
+
+    return texID;
+}
+
+// Função para carregar a spritesheet como textura array e retornar o ID da textura
+// Cada frame vira uma camada com suas próprias mipmaps, então filtragem linear e redução nunca misturam
+// frames vizinhos e o shader só precisa do índice da camada, sem conta de UV por frame
+GLuint TextureCache::loadArrayFromFile(const std::string& texturePath, int columns, int rows, int& width, int& height) {
+    GLuint texID;
+    glGenTextures(1, &texID);
+    RenderState::bindTexture(texID, 0, GL_TEXTURE_2D_ARRAY);
+
+    // Bordas presas à camada e mipmaps na redução; a ampliação continua NEAREST, como nas outras texturas
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // Mesma orientação das texturas 2D: a linha 0 do grid é a de baixo da imagem, como no tile.vs
+    // O nível 0 vem do mesmo cache das texturas 2D; as mipmaps são geradas por camada
+    DecodedImage image;
+    bool loaded = image.load(texturePath);
+    int imageWidth = image.getWidth(), imageHeight = image.getHeight();
+    const unsigned char* data = loaded ? image.getLevel(0).pixels : nullptr;
+    GLenum format = image.getChannels() == 3 ? GL_RGB : GL_RGBA;
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    width = height = 0;
+    if (!loaded) {
+        return texID;   // O DecodedImage já informou o erro
+    }
+    if (columns <= 0 || rows <= 0 || imageWidth < columns || imageHeight < rows || columns * rows > maxLayers) {
+        std::cerr << "Cannot slice " << texturePath << " into " << columns << "x" << rows << " layers" << std::endl;
+    }
+    else {
+        width = imageWidth / columns;
+        height = imageHeight / rows;
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, columns * rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        // Envia cada frame direto da imagem decodificada, pulando as colunas dos outros frames com GL_UNPACK_ROW_LENGTH
+        size_t pixelSize = static_cast<size_t>(image.getChannels());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, imageWidth);
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                const unsigned char* frame = data + (static_cast<size_t>(row) * height * imageWidth + static_cast<size_t>(column) * width) * pixelSize;
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, row * columns + column, width, height, 1, format, GL_UNSIGNED_BYTE, frame);
+            }
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+        // Permite o PNG mesclar com o fundo caso tenha fundo nulo
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    return texID;
+}
+
+// Função que envia todos os níveis de mipmap da imagem para a textura vinculada
+// Sem glGenerateMipmap: as mipmaps já vêm prontas do cache
+void TextureCache::uploadLevels(GLenum target, const DecodedImage& image) {
+    GLenum format = image.getChannels() == 3 ? GL_RGB : GL_RGBA;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);      // Linhas RGB não são múltiplas de 4 bytes
+    for (size_t level = 0; level < image.getLevelCount(); ++level) {
+        const ImageLevel& mip = image.getLevel(level);
+        glTexImage2D(target, static_cast<GLint>(level), format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE, mip.pixels);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.getLevelCount()) - 1);
+}
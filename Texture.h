@@ -0,0 +1,136 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Classe que representa uma textura carregada na GPU
+// O identificador OpenGL é liberado quando o objeto é destruído. Uma textura carregada pelo TextureStreamer
+// começa apontando para o placeholder e só passa a ter o próprio ID quando a imagem chega inteira na GPU
+class Texture {
+public:
+    // Construtor: recebe o ID da textura já enviada para a GPU, suas dimensões e o tipo (GL_TEXTURE_2D ou GL_TEXTURE_2D_ARRAY)
+    Texture(GLuint id, int width, int height, GLenum target = GL_TEXTURE_2D, int layers = 1);
+
+    // Construtor de uma textura 2D ainda em carregamento: usa o ID do placeholder, que não é liberado pelo destrutor
+    explicit Texture(GLuint placeholderID);
+
+    // Libera a textura da GPU
+    ~Texture();
+
+    // Uma textura tem um único dono na GPU, por isso não pode ser copiada
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    // Retorna o ID da textura
+    GLuint getID() const;
+
+    // Retorna a largura e altura da imagem em pixels (de uma camada, em texturas array)
+    int getWidth() const;
+    int getHeight() const;
+
+    // Retorna o tipo da textura e a quantidade de camadas
+    GLenum getTarget() const;
+    int getLayers() const;
+
+    // Vincula a textura na unidade informada, pelo RenderState
+    void bind(GLuint unit = 0) const;
+
+    // Indica se a imagem já está na GPU (false enquanto a textura usa o placeholder)
+    bool isResident() const;
+
+    // Troca o placeholder pela textura enviada; chamado pelo TextureStreamer na thread da OpenGL
+    void setResident(GLuint id, int width, int height);
+
+private:
+    GLuint id;      // ID da textura na OpenGL
+    int width;      // Largura da imagem
+    int height;     // Altura da imagem
+    GLenum target;  // GL_TEXTURE_2D ou GL_TEXTURE_2D_ARRAY
+    int layers;     // Camadas (1 em texturas 2D)
+    bool resident;  // Se 'id' é da própria textura (e não do placeholder)
+};
+
+class DecodedImage;
+class TextureStreamer;
+
+// Referência compartilhada para uma textura do cache
+using TextureHandle = std::shared_ptr<Texture>;
+
+// Textura e área dela ocupada por uma imagem: a imagem inteira ou uma região de um atlas
+struct TextureRegion {
+    TextureHandle texture;                          // Textura que contém a imagem
+    glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);  // Offset (xy) e tamanho (zw) da imagem na textura
+};
+
+// Cache de texturas com contagem de referências, indexado pelo caminho do arquivo
+// Cada imagem é decodificada e enviada para a GPU uma única vez; a textura é liberada
+// quando o último TextureHandle que aponta para ela é destruído
+// Com o carregamento assíncrono ligado (startStreaming), o load() retorna na hora uma textura com o placeholder
+// e a imagem é decodificada e enviada pelo TextureStreamer ao longo dos frames seguintes
+class TextureCache {
+public:
+    // Retorna a textura do caminho informado, carregando-a somente se ainda não estiver em uso
+    static TextureHandle load(const std::string& texturePath);
+
+    // Liga o carregamento assíncrono das texturas 2D, com 'workerCount' threads de decodificação
+    static void startStreaming(int workerCount = 2);
+
+    // Desliga o carregamento assíncrono; as texturas ainda incompletas ficam no placeholder
+    // Deve ser chamado antes de destruir o contexto OpenGL
+    static void stopStreaming();
+
+    // Envia para a GPU até 'byteBudget' bytes das texturas em carregamento; deve ser chamado uma vez por frame
+    static void update(size_t byteBudget = 1u << 20);
+
+    // Retorna a quantidade de texturas ainda em carregamento
+    static size_t getPendingCount();
+
+    // Registra as regiões de um atlas (manifesto gerado por tools/AtlasPacker.cpp); retorna false se não for possível ler
+    static bool loadAtlas(const std::string& manifestPath);
+
+    // Retorna a região do atlas com o nome informado ou, se a imagem não estiver em um atlas, a textura inteira
+    static TextureRegion loadRegion(const std::string& texturePath);
+
+    // Retorna a spritesheet fatiada em uma textura array com uma camada por frame (columns x rows frames),
+    // na ordem dos índices de textura do tilemap: camada = linha * columns + coluna
+    static TextureHandle loadArray(const std::string& texturePath, int columns, int rows);
+
+    // Retorna a quantidade de texturas atualmente carregadas
+    static size_t size();
+
+private:
+    friend class TextureStreamer;
+
+    // Cria uma textura 2D vazia com os parâmetros de todas as texturas do jogo e a deixa vinculada
+    static GLuint createTexture2D();
+
+    // Retorna a textura 1x1 mostrada enquanto a imagem carrega, criando-a no primeiro uso
+    static GLuint placeholderID();
+
+    // Decodifica a imagem e envia para a GPU, retornando o ID da textura
+    static GLuint loadFromFile(const std::string& texturePath, int& width, int& height);
+
+    // Envia para a textura vinculada todos os níveis de mipmap da imagem
+    static void uploadLevels(GLenum target, const DecodedImage& image);
+
+    // Decodifica a spritesheet e envia cada frame para uma camada de uma textura array, retornando o ID da textura
+    static GLuint loadArrayFromFile(const std::string& texturePath, int columns, int rows, int& width, int& height);
+
+    // Região de uma imagem registrada pelo loadAtlas
+    struct AtlasEntry {
+        std::string pagePath;   // Caminho da página do atlas
+        glm::vec4 uvRect;       // Área da imagem na página
+    };
+
+    static std::unordered_map<std::string, std::weak_ptr<Texture>> textures;  // Texturas indexadas pelo caminho
+    static std::unordered_map<std::string, AtlasEntry> atlasEntries;          // Regiões de atlas indexadas pelo caminho original
+    static std::unique_ptr<TextureStreamer> streamer;                         // Carregamento assíncrono (nulo quando desligado)
+    static GLuint placeholder;                                                // Textura mostrada durante o carregamento
+};
+
+#endif
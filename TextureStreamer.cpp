@@ -0,0 +1,211 @@
+#include "TextureStreamer.h"
+#include "RenderState.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstring>
+
+const int TextureStreamer::DEFAULT_WORKER_COUNT;
+const size_t TextureStreamer::DEFAULT_UPLOAD_BUDGET;
+const int TextureStreamer::PBO_COUNT;
+
+// Construtor da classe TextureStreamer
+TextureStreamer::TextureStreamer(int workerCount)
+    : decoding(0), stopping(false), nextPixelBuffer(0), lastUploadBytes(0) {
+    std::fill(pixelBuffers, pixelBuffers + PBO_COUNT, 0u);
+    for (int i = 0; i < std::max(1, workerCount); ++i) {
+        workers.emplace_back(&TextureStreamer::workerLoop, this);
+    }
+}
+
+// Destrutor: encerra as threads de trabalho antes de liberar os recursos
+TextureStreamer::~TextureStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    if (glfwGetCurrentContext() != nullptr) {
+        while (!uploads.empty()) {
+            cancelUpload();
+        }
+        if (pixelBuffers[0] != 0) {
+            glDeleteBuffers(PBO_COUNT, pixelBuffers);
+        }
+    }
+}
+
+// Função que registra o pedido de uma imagem
+void TextureStreamer::request(const std::string& texturePath, const TextureHandle& texture) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto it = targets.find(texturePath);
+        if (it != targets.end()) {
+            it->second = texture;
+            return;
+        }
+        targets[texturePath] = texture;
+        jobs.push_back(texturePath);
+    }
+    queueCondition.notify_one();
+}
+
+// Função chamada a cada frame para enviar as imagens decodificadas
+void TextureStreamer::update(size_t byteBudget) {
+    lastUploadBytes = 0;
+
+    // Pega as imagens decodificadas desde o último frame; a decodificação não bloqueia a thread da OpenGL
+    std::vector<DecodeResult> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        ready.swap(results);
+    }
+    for (DecodeResult& result : ready) {
+        beginUpload(result);
+    }
+    if (uploads.empty()) {
+        return;
+    }
+
+    if (pixelBuffers[0] == 0) {
+        glGenBuffers(PBO_COUNT, pixelBuffers);
+    }
+
+    // Envia fatias até acabar o orçamento; sempre ao menos uma linha, para o envio nunca parar
+    while (!uploads.empty() && (lastUploadBytes == 0 || lastUploadBytes < byteBudget)) {
+        Upload& upload = uploads.front();
+        TextureHandle texture = upload.texture.lock();
+        if (!texture) {
+            // Ninguém usa mais a textura: o envio é descartado
+            cancelUpload();
+            continue;
+        }
+
+        lastUploadBytes += uploadSlice(upload, byteBudget - std::min(byteBudget, lastUploadBytes));
+        if (upload.level == upload.image->getLevelCount()) {
+            RenderState::bindTexture(upload.id);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(upload.image->getLevelCount()) - 1);
+            texture->setResident(upload.id, upload.image->getWidth(), upload.image->getHeight());
+            uploads.pop_front();
+
+            // Permite o PNG mesclar com o fundo caso tenha fundo nulo
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+    }
+}
+
+// Função para retornar a quantidade de imagens ainda não residentes
+size_t TextureStreamer::getPendingCount() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return jobs.size() + decoding + results.size() + uploads.size();
+}
+
+// Função executada pelas threads de trabalho
+void TextureStreamer::workerLoop() {
+    while (true) {
+        DecodeResult result;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            result.path = jobs.front();
+            jobs.pop_front();
+            ++decoding;
+        }
+
+        // O caminho continua em 'targets' durante a decodificação, então outra thread nunca grava o mesmo cache
+        result.image.reset(new DecodedImage());
+        result.loaded = result.image->load(result.path);
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            results.push_back(std::move(result));
+            --decoding;
+        }
+    }
+}
+
+// Função que cria a textura da OpenGL de uma imagem decodificada e a coloca na fila de envio
+// Todos os níveis são alocados de uma vez (sem dados); as fatias só preenchem a memória já reservada
+void TextureStreamer::beginUpload(DecodeResult& result) {
+    std::weak_ptr<Texture> target;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto it = targets.find(result.path);
+        if (it != targets.end()) {
+            target = it->second;
+            targets.erase(it);
+        }
+    }
+
+    // Imagem ilegível (o DecodedImage já informou o erro) ou textura sem usuários: fica no placeholder
+    if (!result.loaded || target.expired()) {
+        return;
+    }
+
+    Upload upload;
+    upload.texture = target;
+    upload.image = std::move(result.image);
+    upload.id = TextureCache::createTexture2D();
+    upload.level = 0;
+    upload.row = 0;
+
+    GLenum format = upload.image->getChannels() == 3 ? GL_RGB : GL_RGBA;
+    for (size_t level = 0; level < upload.image->getLevelCount(); ++level) {
+        const ImageLevel& mip = upload.image->getLevel(level);
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    }
+    uploads.push_back(std::move(upload));
+}
+
+// Função que copia linhas do nível atual para um pixel buffer e as envia para a textura
+// O buffer é realocado a cada fatia (orphaning), assim o driver nunca espera a GPU terminar de ler a fatia anterior,
+// e o glTexSubImage2D lê do buffer em vez da memória do processo
+size_t TextureStreamer::uploadSlice(Upload& upload, size_t byteBudget) {
+    const ImageLevel& mip = upload.image->getLevel(upload.level);
+    size_t rowBytes = static_cast<size_t>(mip.width) * upload.image->getChannels();
+    int rows = static_cast<int>(std::min<size_t>(mip.height - upload.row, std::max<size_t>(1, byteBudget / rowBytes)));
+    size_t sliceBytes = rowBytes * rows;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[nextPixelBuffer]);
+    nextPixelBuffer = (nextPixelBuffer + 1) % PBO_COUNT;
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(sliceBytes), nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(sliceBytes),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped != nullptr) {
+        std::memcpy(mapped, mip.pixels + rowBytes * upload.row, sliceBytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        GLenum format = upload.image->getChannels() == 3 ? GL_RGB : GL_RGBA;
+        RenderState::bindTexture(upload.id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);      // Linhas RGB não são múltiplas de 4 bytes
+        glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(upload.level), 0, upload.row, mip.width, rows, format, GL_UNSIGNED_BYTE, nullptr);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // Se o mapeamento falhar a mesma fatia é tentada de novo no próximo frame
+    if (mapped == nullptr) {
+        return sliceBytes;
+    }
+    upload.row += rows;
+    if (upload.row == mip.height) {
+        ++upload.level;
+        upload.row = 0;
+    }
+    return sliceBytes;
+}
+
+// Função que descarta o envio atual
+void TextureStreamer::cancelUpload() {
+    GLuint id = uploads.front().id;
+    glDeleteTextures(1, &id);
+    RenderState::textureDeleted(id);
+    uploads.pop_front();
+}
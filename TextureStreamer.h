@@ -0,0 +1,92 @@
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+#include "DecodedImage.h"
+#include "Texture.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Classe que carrega texturas sem travar a thread da OpenGL
+// Threads de trabalho decodificam as imagens (DecodedImage, pelo cache .gbtex ou pelo stb_image); a thread da
+// OpenGL envia os níveis de mipmap em fatias de linhas por pixel buffer objects, respeitando um orçamento de
+// bytes por frame. Enquanto a imagem não chega inteira, a Texture usa o placeholder do TextureCache
+class TextureStreamer {
+public:
+    static const int DEFAULT_WORKER_COUNT = 2;                  // Threads de decodificação
+    static const size_t DEFAULT_UPLOAD_BUDGET = 1u << 20;       // Bytes enviados para a GPU por frame (1 MB)
+    static const int PBO_COUNT = 3;                             // Pixel buffers usados em rodízio
+
+    // Construtor: inicia as threads de trabalho; os pixel buffers só são criados no primeiro update()
+    explicit TextureStreamer(int workerCount = DEFAULT_WORKER_COUNT);
+
+    // Para as threads de trabalho e libera os buffers e as texturas ainda incompletas
+    ~TextureStreamer();
+
+    // As threads de trabalho guardam 'this', por isso o streamer não pode ser copiado
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Pede o carregamento da imagem para a textura informada; um pedido pendente do mesmo caminho passa a
+    // apontar para ela, sem decodificar de novo
+    void request(const std::string& texturePath, const TextureHandle& texture);
+
+    // Envia para a GPU até 'byteBudget' bytes das imagens já decodificadas e torna residentes as que terminarem
+    // Deve ser chamado uma vez por frame na thread da OpenGL
+    void update(size_t byteBudget = DEFAULT_UPLOAD_BUDGET);
+
+    // Métodos para obter a quantidade de imagens aguardando decodificação ou envio, e os bytes enviados no último update()
+    size_t getPendingCount();
+    size_t getLastUploadBytes() const { return lastUploadBytes; }
+
+private:
+    // Imagem decodificada por uma thread de trabalho
+    struct DecodeResult {
+        std::string path;
+        std::unique_ptr<DecodedImage> image;
+        bool loaded;            // Se a imagem pôde ser lida
+    };
+
+    // Imagem sendo enviada para a GPU, uma fatia de linhas por vez
+    struct Upload {
+        std::weak_ptr<Texture> texture;     // Textura que recebe a imagem
+        std::unique_ptr<DecodedImage> image;
+        GLuint id;              // Textura da OpenGL sendo preenchida
+        size_t level;           // Nível de mipmap atual
+        int row;                // Próxima linha do nível atual
+    };
+
+    // Laço das threads de trabalho: decodifica as imagens pedidas
+    void workerLoop();
+
+    // Começa o envio de uma imagem decodificada: cria a textura da OpenGL com todos os níveis vazios
+    void beginUpload(DecodeResult& result);
+
+    // Envia linhas do nível atual pelo próximo pixel buffer; retorna os bytes enviados
+    size_t uploadSlice(Upload& upload, size_t byteBudget);
+
+    // Descarta o envio atual, liberando a textura da OpenGL
+    void cancelUpload();
+
+    std::vector<std::thread> workers;                   // Threads que decodificam as imagens
+    std::mutex queueMutex;                              // Protege jobs, targets, results, decoding e stopping
+    std::condition_variable queueCondition;             // Acorda as threads de trabalho
+    std::deque<std::string> jobs;                       // Caminhos a decodificar, na ordem dos pedidos
+    std::unordered_map<std::string, std::weak_ptr<Texture>> targets;  // Textura de cada caminho pedido
+    std::vector<DecodeResult> results;                  // Imagens decodificadas aguardando envio
+    size_t decoding;                                    // Imagens sendo decodificadas agora
+    bool stopping;                                      // Pede o fim das threads de trabalho
+
+    std::deque<Upload> uploads;                         // Imagens sendo enviadas, a primeira é a atual
+    GLuint pixelBuffers[PBO_COUNT];                     // Pixel buffers (GL_PIXEL_UNPACK_BUFFER)
+    int nextPixelBuffer;                                // Próximo pixel buffer do rodízio
+    size_t lastUploadBytes;                             // Bytes enviados no último update()
+};
+
+#endif
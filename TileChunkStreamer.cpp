@@ -0,0 +1,333 @@
+#include "TileChunkStreamer.h"
+#include "RenderState.h"
+#include "SharedQuad.h"
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <unordered_set>
+
+const int TileChunkStreamer::CHUNK_SIZE;
+const size_t TileChunkStreamer::DEFAULT_MEMORY_BUDGET;
+const int TileChunkStreamer::MAX_UPLOADS_PER_FRAME;
+
+// Construtor da classe TileChunkStreamer
+TileChunkStreamer::TileChunkStreamer(TileGrid& grid, size_t memoryBudget)
+    : grid(grid), memoryBudget(memoryBudget), residentBytes(0), frame(0), inFlight(-1), stopping(false) {
+    chunksX = (grid.getWidth() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunksY = (grid.getHeight() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunkVersions.assign(static_cast<size_t>(chunksX) * chunksY, 0);
+
+    // Quad unitário compartilhado com o TilemapRenderer e a RenderQueue
+    SharedQuad::acquire();
+
+    worker = std::thread(&TileChunkStreamer::workerLoop, this);
+}
+
+// Destrutor: encerra a thread de trabalho antes de liberar os recursos
+TileChunkStreamer::~TileChunkStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    worker.join();
+
+    if (glfwGetCurrentContext() != nullptr) {
+        for (auto& entry : resident) {
+            releaseChunk(entry.second);
+        }
+    }
+    SharedQuad::release();
+}
+
+// Função chamada a cada frame para decidir quais chunks ficam na GPU
+void TileChunkStreamer::update(const IsoBounds& visible) {
+    ++frame;
+
+    // Um chunk de CHUNK_SIZE tiles de margem é pedido antes de entrar na tela, para não travar ao cruzar a borda
+    const int prefetch = CHUNK_SIZE;
+    IsoBounds area = { visible.uMin - prefetch, visible.uMax + prefetch, visible.dMin - prefetch, visible.dMax + prefetch };
+
+    // Retângulo de tiles que contém a área (x = (u + d) / 2, y = (d - u) / 2), convertido para chunks
+    int minChunkX = std::max(0, static_cast<int>(std::floor((area.uMin + area.dMin) / 2.0f)) / CHUNK_SIZE);
+    int maxChunkX = std::min(chunksX - 1, static_cast<int>(std::ceil((area.uMax + area.dMax) / 2.0f)) / CHUNK_SIZE);
+    int minChunkY = std::max(0, static_cast<int>(std::floor((area.dMin - area.uMax) / 2.0f)) / CHUNK_SIZE);
+    int maxChunkY = std::min(chunksY - 1, static_cast<int>(std::ceil((area.dMax - area.uMin) / 2.0f)) / CHUNK_SIZE);
+
+    // Centro da área visível em chunks, usado para pedir primeiro os chunks mais próximos
+    float centerX = (visible.uMin + visible.uMax + visible.dMin + visible.dMax) / 4.0f / CHUNK_SIZE;
+    float centerY = (visible.dMin + visible.dMax - visible.uMin - visible.uMax) / 4.0f / CHUNK_SIZE;
+
+    wanted.clear();
+    drawList.clear();
+    std::vector<std::pair<float, int>> missing;
+    for (int chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY) {
+        for (int chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX) {
+            // Faixas de u e d cobertas pelo chunk
+            int x0 = chunkX * CHUNK_SIZE, x1 = std::min(grid.getWidth(), x0 + CHUNK_SIZE) - 1;
+            int y0 = chunkY * CHUNK_SIZE, y1 = std::min(grid.getHeight(), y0 + CHUNK_SIZE) - 1;
+            int dLow = x0 + y0, dHigh = x1 + y1, uLow = x0 - y1, uHigh = x1 - y0;
+
+            if (dHigh < area.dMin || dLow > area.dMax || uHigh < area.uMin || uLow > area.uMax) {
+                continue;
+            }
+
+            int key = chunkKey(chunkX, chunkY);
+            wanted.push_back(key);
+            if (dHigh >= visible.dMin && dLow <= visible.dMax && uHigh >= visible.uMin && uLow <= visible.uMax) {
+                drawList.push_back(key);
+            }
+
+            auto it = resident.find(key);
+            if (it != resident.end()) {
+                it->second.lastUsedFrame = frame;
+            }
+            else {
+                float dx = chunkX + 0.5f - centerX, dy = chunkY + 0.5f - centerY;
+                missing.push_back({ dx * dx + dy * dy, key });
+            }
+        }
+    }
+    std::sort(missing.begin(), missing.end());
+
+    // Ordem de pintura entre chunks: diagonal de chunk decrescente. Tiles vizinhos em chunks da mesma
+    // diagonal ficam a duas colunas isométricas de distância, então não se sobrepõem
+    std::sort(drawList.begin(), drawList.end(), [this](int a, int b) {
+        int diagonalA = a % chunksX + a / chunksX;
+        int diagonalB = b % chunksX + b / chunksX;
+        if (diagonalA != diagonalB) {
+            return diagonalA > diagonalB;
+        }
+        return a < b;
+        });
+
+    // Recolhe os chunks montados e envia alguns por frame; o restante fica para os próximos frames
+    std::vector<BuildResult> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        ready.swap(results);
+    }
+    std::vector<BuildResult> heldBack;
+    int uploads = 0;
+    for (size_t i = 0; i < ready.size(); ++i) {
+        BuildResult& result = ready[i];
+        bool stale = result.version != chunkVersions[result.key] || resident.count(result.key) != 0;
+        if (stale) {
+            continue;
+        }
+        if (uploads == MAX_UPLOADS_PER_FRAME) {
+            heldBack.push_back(std::move(result));
+            continue;
+        }
+        uploadChunk(result);
+        ++uploads;
+    }
+
+    // Substitui a fila pelos chunks que faltam agora; os que já foram montados (aguardando envio, inclusive os que
+    // a thread de trabalho entregou durante o envio acima) e o que está sendo montado não voltam para a fila
+    bool hasJobs;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        std::unordered_set<int> built;
+        for (const BuildResult& result : results) {
+            built.insert(result.key);
+        }
+        for (BuildResult& result : heldBack) {
+            built.insert(result.key);
+            results.push_back(std::move(result));
+        }
+
+        jobs.clear();
+        for (const auto& entry : missing) {
+            if (entry.second != inFlight && resident.count(entry.second) == 0 && built.count(entry.second) == 0) {
+                jobs.push_back(entry.second);
+            }
+        }
+        hasJobs = !jobs.empty();
+    }
+    if (hasJobs) {
+        queueCondition.notify_one();
+    }
+
+    evictChunks();
+}
+
+// Função que desenha os chunks visíveis residentes, uma chamada de desenho por chunk
+void TileChunkStreamer::draw(Shader& shader, const Texture* texture) const {
+    shader.Use();
+    if (texture) {
+        texture->bind();
+    }
+    for (int key : drawList) {
+        auto it = resident.find(key);
+        if (it == resident.end()) {
+            continue;
+        }
+        RenderState::bindVertexArray(it->second.VAO);
+        glDrawElementsInstanced(GL_TRIANGLES, SharedQuad::INDEX_COUNT, SharedQuad::INDEX_TYPE, 0, it->second.count);
+    }
+}
+
+// Função que troca a textura de uma célula
+// Se o chunk estiver na GPU só os 2 bytes do índice são enviados; montagens em andamento
+// do mesmo chunk ficam desatualizadas pela nova versão e são descartadas
+void TileChunkStreamer::setTile(int x, int y, TileGrid::TileId textureIndex) {
+    int chunkX = x / CHUNK_SIZE, chunkY = y / CHUNK_SIZE;
+    int key = chunkKey(chunkX, chunkY);
+    {
+        std::lock_guard<std::mutex> lock(gridMutex);
+        grid(x, y) = textureIndex;
+        ++chunkVersions[key];
+    }
+
+    auto it = resident.find(key);
+    if (it != resident.end()) {
+        int x0 = chunkX * CHUNK_SIZE, y0 = chunkY * CHUNK_SIZE;
+        int width = std::min(grid.getWidth() - x0, CHUNK_SIZE);
+        int height = std::min(grid.getHeight() - y0, CHUNK_SIZE);
+        int slot = localSlot(x - x0, y - y0, width, height);
+
+        glBindBuffer(GL_ARRAY_BUFFER, it->second.VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, slot * sizeof(TileInstance) + offsetof(TileInstance, textureIndex), sizeof(textureIndex), &textureIndex);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+// Função para definir o orçamento de memória
+void TileChunkStreamer::setMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+    evictChunks();
+}
+
+// Função para retornar a memória de GPU ocupada pelos chunks
+size_t TileChunkStreamer::getResidentBytes() const {
+    return residentBytes;
+}
+
+// Função para retornar a quantidade de chunks na GPU
+size_t TileChunkStreamer::getResidentChunkCount() const {
+    return resident.size();
+}
+
+// Função que calcula a posição de uma célula no buffer do chunk
+// O buffer está em diagonal decrescente e x crescente, então a posição é a quantidade de células
+// nas diagonais mais distantes somada à posição da célula na sua diagonal
+int TileChunkStreamer::localSlot(int localX, int localY, int width, int height) {
+    int diagonal = localX + localY;
+    int slot = 0;
+    for (int d = width + height - 2; d > diagonal; --d) {
+        slot += std::min(d, width - 1) - std::max(0, d - (height - 1)) + 1;
+    }
+    return slot + localX - std::max(0, diagonal - (height - 1));
+}
+
+// Laço da thread de trabalho
+void TileChunkStreamer::workerLoop() {
+    while (true) {
+        int key;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            key = jobs.front();
+            jobs.pop_front();
+            inFlight = key;
+        }
+
+        BuildResult result;
+        result.key = key;
+        {
+            std::lock_guard<std::mutex> lock(gridMutex);
+            result.version = chunkVersions[key];
+            buildChunk(key, result.instances);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            results.push_back(std::move(result));
+            inFlight = -1;
+        }
+    }
+}
+
+// Função que monta os TileInstance de um chunk em ordem de pintura
+void TileChunkStreamer::buildChunk(int key, std::vector<TileInstance>& instances) {
+    int x0 = (key % chunksX) * CHUNK_SIZE;
+    int y0 = (key / chunksX) * CHUNK_SIZE;
+    int width = std::min(grid.getWidth() - x0, CHUNK_SIZE);
+    int height = std::min(grid.getHeight() - y0, CHUNK_SIZE);
+
+    instances.clear();
+    instances.reserve(width * height);
+    for (int d = width + height - 2; d >= 0; --d) {
+        int first = std::max(0, d - (height - 1));
+        int last = std::min(width - 1, d);
+        for (int localX = first; localX <= last; ++localX) {
+            int x = x0 + localX;
+            int y = y0 + d - localX;
+            instances.push_back(TileInstance{ static_cast<uint16_t>(x), static_cast<uint16_t>(y), grid(x, y), 0 });
+        }
+    }
+}
+
+// Função que cria os buffers de um chunk na GPU
+void TileChunkStreamer::uploadChunk(BuildResult& result) {
+    Chunk chunk;
+    chunk.count = static_cast<GLsizei>(result.instances.size());
+    chunk.lastUsedFrame = frame;
+
+    glGenVertexArrays(1, &chunk.VAO);
+    glGenBuffers(1, &chunk.VBO);
+
+    RenderState::bindVertexArray(chunk.VAO);
+
+    SharedQuad::attach();
+
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+    glBufferData(GL_ARRAY_BUFFER, result.instances.size() * sizeof(TileInstance), result.instances.data(), GL_STATIC_DRAW);
+    glVertexAttribIPointer(3, 3, GL_UNSIGNED_SHORT, sizeof(TileInstance), (GLvoid*)0);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    RenderState::bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    residentBytes += result.instances.size() * sizeof(TileInstance);
+    resident[result.key] = chunk;
+}
+
+// Função que libera os buffers de um chunk
+void TileChunkStreamer::releaseChunk(Chunk& chunk) {
+    glDeleteVertexArrays(1, &chunk.VAO);
+    RenderState::vertexArrayDeleted(chunk.VAO);
+    glDeleteBuffers(1, &chunk.VBO);
+    chunk.VAO = chunk.VBO = 0;
+}
+
+// Função que descarta chunks até caber no orçamento
+// Chunks pedidos neste frame nunca são descartados
+void TileChunkStreamer::evictChunks() {
+    if (residentBytes <= memoryBudget) {
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, int>> candidates;
+    for (const auto& entry : resident) {
+        if (entry.second.lastUsedFrame != frame) {
+            candidates.push_back({ entry.second.lastUsedFrame, entry.first });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& candidate : candidates) {
+        if (residentBytes <= memoryBudget) {
+            break;
+        }
+        Chunk& chunk = resident[candidate.second];
+        residentBytes -= chunk.count * sizeof(TileInstance);
+        releaseChunk(chunk);
+        resident.erase(candidate.second);
+    }
+}
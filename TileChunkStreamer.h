@@ -0,0 +1,109 @@
+#ifndef TILECHUNKSTREAMER_H
+#define TILECHUNKSTREAMER_H
+
+#include "TilemapRenderer.h"
+#include "TileGrid.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Classe que mantém na GPU somente os chunks do mapa próximos da câmera
+// O mapa é dividido em chunks de CHUNK_SIZE x CHUNK_SIZE tiles. Uma thread de trabalho monta os
+// TileInstance de cada chunk; a thread da OpenGL só envia os buffers prontos, alguns por frame.
+// Chunks fora da área desejada são descartados (o menos usado primeiro) quando a memória de GPU
+// ocupada passa do orçamento configurado
+class TileChunkStreamer {
+public:
+    static const int CHUNK_SIZE = 32;                       // Tamanho do chunk em tiles
+    static const size_t DEFAULT_MEMORY_BUDGET = 16u << 20;  // Orçamento padrão de memória de GPU (16 MB)
+    static const int MAX_UPLOADS_PER_FRAME = 4;             // Chunks enviados para a GPU por frame
+
+    // Construtor: recebe a grid do mapa (que deve sobreviver ao streamer) e inicia a thread de trabalho
+    TileChunkStreamer(TileGrid& grid, size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+    // Para a thread de trabalho e libera os buffers da GPU
+    ~TileChunkStreamer();
+
+    // A thread de trabalho guarda 'this', por isso o streamer não pode ser copiado
+    TileChunkStreamer(const TileChunkStreamer&) = delete;
+    TileChunkStreamer& operator=(const TileChunkStreamer&) = delete;
+
+    // Atualiza os chunks desejados a partir da área visível, envia os chunks prontos e descarta os excedentes
+    // Deve ser chamado uma vez por frame na thread da OpenGL
+    void update(const IsoBounds& visible);
+
+    // Desenha os chunks visíveis que já estão na GPU, na ordem de pintura
+    void draw(Shader& shader, const Texture* texture) const;
+
+    // Troca o índice de textura de uma célula na grid e no chunk residente que a contém
+    void setTile(int x, int y, TileGrid::TileId textureIndex);
+
+    // Define o orçamento de memória de GPU em bytes
+    void setMemoryBudget(size_t bytes);
+
+    // Métodos para obter a memória de GPU e a quantidade de chunks residentes
+    size_t getResidentBytes() const;
+    size_t getResidentChunkCount() const;
+
+private:
+    // Chunk residente na GPU
+    struct Chunk {
+        GLuint VAO;             // VAO com o quad compartilhado e as instâncias do chunk
+        GLuint VBO;             // Buffer de TileInstance do chunk
+        GLsizei count;          // Quantidade de tiles do chunk
+        uint64_t lastUsedFrame; // Último frame em que o chunk estava na área desejada
+    };
+
+    // Chunk montado pela thread de trabalho, aguardando o envio para a GPU
+    struct BuildResult {
+        int key;                            // Chunk montado
+        uint32_t version;                   // Versão da grid usada na montagem
+        std::vector<TileInstance> instances;
+    };
+
+    // Métodos para converter entre coordenadas de chunk e a chave do chunk
+    int chunkKey(int chunkX, int chunkY) const { return chunkY * chunksX + chunkX; }
+
+    // Método que calcula a posição de (x, y) dentro do buffer do chunk
+    static int localSlot(int localX, int localY, int width, int height);
+
+    // Laço da thread de trabalho: monta os chunks pedidos
+    void workerLoop();
+
+    // Monta os TileInstance de um chunk em ordem de pintura (diagonal decrescente, x crescente)
+    void buildChunk(int key, std::vector<TileInstance>& instances);
+
+    // Envia um chunk montado para a GPU
+    void uploadChunk(BuildResult& result);
+
+    // Libera um chunk da GPU
+    void releaseChunk(Chunk& chunk);
+
+    // Descarta os chunks menos usados fora da área desejada até caber no orçamento
+    void evictChunks();
+
+    TileGrid& grid;                             // Grid do mapa
+    int chunksX, chunksY;                       // Quantidade de chunks em cada eixo
+    std::vector<uint32_t> chunkVersions;        // Versão de cada chunk, incrementada a cada edição
+    std::unordered_map<int, Chunk> resident;    // Chunks na GPU
+    std::vector<int> wanted;                    // Chunks desejados no último update
+    std::vector<int> drawList;                  // Chunks visíveis em ordem de pintura
+    size_t memoryBudget;                        // Orçamento de memória de GPU
+    size_t residentBytes;                       // Memória de GPU ocupada pelos chunks
+    uint64_t frame;                             // Contador de frames para o descarte LRU
+
+    std::thread worker;                         // Thread que monta os chunks
+    std::mutex queueMutex;                      // Protege jobs, inFlight, results e stopping
+    std::condition_variable queueCondition;     // Acorda a thread de trabalho
+    std::deque<int> jobs;                       // Chunks a montar, o mais próximo da câmera primeiro
+    int inFlight;                               // Chunk sendo montado agora (-1 se nenhum)
+    std::vector<BuildResult> results;           // Chunks montados aguardando envio
+    bool stopping;                              // Pede o fim da thread de trabalho
+    std::mutex gridMutex;                       // Protege a grid entre setTile e a thread de trabalho
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "TileGrid.h"
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// Construtor da classe TileGrid
+TileGrid::TileGrid() : width(0), height(0), cells(nullptr) {
+}
+
+// Construtor que já aloca a grid
+TileGrid::TileGrid(int width, int height, TileId fill) : width(0), height(0), cells(nullptr) {
+    resize(width, height, fill);
+}
+
+// Construtor de cópia: copia as células para um buffer próprio, mesmo que a origem seja externa
+TileGrid::TileGrid(const TileGrid& other)
+    : width(other.width), height(other.height), tiles(other.cells, other.cells + other.size()) {
+    cells = tiles.empty() ? nullptr : tiles.data();
+}
+
+// Construtor de movimento: o vetor leva o buffer junto, então o ponteiro continua válido
+TileGrid::TileGrid(TileGrid&& other) noexcept
+    : width(other.width), height(other.height), tiles(std::move(other.tiles)), cells(other.cells) {
+    other.width = 0;
+    other.height = 0;
+    other.cells = nullptr;
+}
+
+TileGrid& TileGrid::operator=(const TileGrid& other) {
+    if (this != &other) {
+        TileGrid copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+TileGrid& TileGrid::operator=(TileGrid&& other) noexcept {
+    if (this != &other) {
+        width = other.width;
+        height = other.height;
+        tiles = std::move(other.tiles);
+        cells = other.cells;
+        other.width = 0;
+        other.height = 0;
+        other.cells = nullptr;
+    }
+    return *this;
+}
+
+// Função para redimensionar a grid com uma única alocação
+void TileGrid::resize(int width, int height, TileId fill) {
+    this->width = width > 0 ? width : 0;
+    this->height = height > 0 ? height : 0;
+    tiles.assign(static_cast<size_t>(this->width) * this->height, fill);
+    cells = tiles.empty() ? nullptr : tiles.data();
+}
+
+// Função que passa a usar um buffer externo, liberando o buffer próprio
+void TileGrid::attach(int width, int height, TileId* external) {
+    std::vector<TileId>().swap(tiles);
+    this->width = external != nullptr && width > 0 ? width : 0;
+    this->height = external != nullptr && height > 0 ? height : 0;
+    cells = this->width > 0 && this->height > 0 ? external : nullptr;
+}
+
+// Função de acesso com verificação de limites
+TileGrid::TileId& TileGrid::at(int x, int y) {
+    checkBounds(x, y);
+    return cells[static_cast<size_t>(y) * width + x];
+}
+
+TileGrid::TileId TileGrid::at(int x, int y) const {
+    checkBounds(x, y);
+    return cells[static_cast<size_t>(y) * width + x];
+}
+
+// Função que valida (x, y)
+void TileGrid::checkBounds(int x, int y) const {
+    if (!inBounds(x, y)) {
+        throw std::out_of_range("TileGrid: (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside a "
+            + std::to_string(width) + "x" + std::to_string(height) + " grid");
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef TILEGRID_H
+#define TILEGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Classe que guarda os índices de textura do mapa em um único buffer contíguo
+// Os tiles ficam em ordem de linha (row-major): a célula (x, y) está em y * largura + x
+// O buffer pode ser próprio (resize) ou externo (attach), como a grid de um arquivo de mapa mapeado em memória
+class TileGrid {
+public:
+    using TileId = uint16_t;    // Índice de textura de um tile (a spritesheet tem bem menos de 65536 tiles)
+
+    // Construtor: cria uma grid vazia
+    TileGrid();
+
+    // Construtor: cria uma grid com as dimensões informadas preenchida com 'fill'
+    TileGrid(int width, int height, TileId fill = 0);
+
+    // Cópia sempre duplica as células em um buffer próprio; o movimento preserva o buffer externo
+    TileGrid(const TileGrid& other);
+    TileGrid(TileGrid&& other) noexcept;
+    TileGrid& operator=(const TileGrid& other);
+    TileGrid& operator=(TileGrid&& other) noexcept;
+
+    // Redimensiona a grid, descartando o conteúdo anterior
+    void resize(int width, int height, TileId fill = 0);
+
+    // Usa um buffer externo de width * height células sem copiá-lo; o buffer deve sobreviver à grid
+    void attach(int width, int height, TileId* external);
+
+    // Indica se as células estão em um buffer externo
+    bool isExternal() const { return cells != nullptr && tiles.empty(); }
+
+    // Métodos para obter as dimensões da grid
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Método para verificar se (x, y) está dentro da grid
+    bool inBounds(int x, int y) const {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(width) && static_cast<unsigned>(y) < static_cast<unsigned>(height);
+    }
+
+    // Acesso sem verificação de limites, para laços que já garantem (x, y) válido
+    // O índice é calculado em size_t, como no row(): em int, y * width passaria de INT_MAX nos mapas grandes
+    TileId& operator()(int x, int y) { return cells[static_cast<size_t>(y) * width + x]; }
+    TileId operator()(int x, int y) const { return cells[static_cast<size_t>(y) * width + x]; }
+
+    // Acesso com verificação de limites; lança std::out_of_range se (x, y) estiver fora da grid
+    TileId& at(int x, int y);
+    TileId at(int x, int y) const;
+
+    // Retorna o ponteiro para o início da linha y
+    TileId* row(int y) { return cells + static_cast<size_t>(y) * width; }
+    const TileId* row(int y) const { return cells + static_cast<size_t>(y) * width; }
+
+    // Retorna o buffer inteiro, usado para serialização
+    TileId* data() { return cells; }
+    const TileId* data() const { return cells; }
+
+    // Retorna a quantidade total de células
+    size_t size() const { return static_cast<size_t>(width) * height; }
+
+private:
+    // Lança std::out_of_range caso (x, y) esteja fora da grid
+    void checkBounds(int x, int y) const;
+
+    int width;                  // Largura da grid em tiles
+    int height;                 // Altura da grid em tiles
+    std::vector<TileId> tiles;  // Índices de textura em ordem de linha (vazio quando o buffer é externo)
+    TileId* cells;              // Início das células: tiles.data() ou o buffer externo
+};
+
+#endif
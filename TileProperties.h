@@ -0,0 +1,21 @@
+#ifndef TILEPROPERTIES_H
+#define TILEPROPERTIES_H
+
+#include <cstdint>
+
+// Flags de gatilho de um tipo de tile (podem ser combinadas)
+enum TileTrigger : uint8_t {
+    TRIGGER_NONE = 0,           // Nenhum gatilho
+    TRIGGER_ON_ENTER = 1 << 0,  // Dispara quando o personagem entra no tile
+    TRIGGER_PICKUP = 1 << 1,    // Tile com item coletável
+    TRIGGER_EXIT = 1 << 2       // Tile de saída do mapa
+};
+
+// Propriedades de um tipo de tile, indexadas pelo índice da textura na spritesheet
+struct TileProperties {
+    bool walkable = true;       // Se o personagem pode andar sobre o tile
+    uint8_t moveCost = 1;       // Custo de movimento para pathfinding
+    uint8_t triggerFlags = TRIGGER_NONE;  // Combinação de TileTrigger
+};
+
+#endif
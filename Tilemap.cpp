@@ -1,136 +1,378 @@
 #include "Tilemap.h"
-#include <stb_image.h>
 #include <algorithm>
+#include <cmath>
 
 const float TILE_SIZE = 128.0f; // Constante para indicar o tamanho do Sprite do Tile
+const int STREAMING_TILE_THRESHOLD = 256 * 256; // Mapas com mais tiles que isso são desenhados por chunks sob demanda
 
 // Construtor da classe Tilemap
-Tilemap::Tilemap(Shader& shader, const std::string& configPath, float screenWidth, float screenHeight) : shader(shader), screenWidth(screenWidth), screenHeight(screenHeight) {
+Tilemap::Tilemap(Shader& shader, const std::string& configPath, float screenWidth, float screenHeight, TilesetMode tilesetMode)
+    : shader(shader), tilesetMode(tilesetMode), tilesetRect(0.0f, 0.0f, 1.0f, 1.0f), submittedBounds(), nextTileEditSequence(0), appliedTileEdit(0), wordsPerRow(0), mapWidth(0), mapHeight(0), tileCount(0), tileRows(1), tileColumns(1), screenWidth(screenWidth), screenHeight(screenHeight) {
     loadMap(configPath);
 }
 
-// Funo para retornar a quantidade de colunas tile
+// Função para retornar a quantidade de colunas tile
 int Tilemap::getTileColumns() const {
     return tileColumns;
 }
 
-// Funo para retornar a quantidade de linhas tile
+// Função para retornar a quantidade de linhas tile
 int Tilemap::getTileRows() const {
     return tileRows;
 }
 
-// Funo para retornar a largura da tela
+// Função para retornar a largura da tela
 float Tilemap::getScreenWidth() const {
     return screenWidth;
 }
 
-// Funo para retornar a altura da tela 
+// Função para retornar a altura da tela 
 float Tilemap::getScreenHeight() const {
     return screenHeight;
 }
 
-// Funo para buscar Sprite pela posio do tile
-Sprite* Tilemap::findSpriteByTilePosition(const glm::vec3& tilePosition) {
-    for (Sprite& tile : tiles) {
-        if (tile.getTilePosition() == tilePosition) {
-            return &tile;
-        }
+// Função para buscar um tile pela sua posição na grid
+// Usa o índice denso tileSlots, que acompanha a ordem de pintura do vetor de tiles
+const Tile* Tilemap::findTileByPosition(int x, int y) const {
+    int slot = tileSlot(x, y);
+    return slot >= 0 ? &tiles[slot] : nullptr;
+}
+
+const Tile* Tilemap::findTileByPosition(const glm::vec3& tilePosition) const {
+    return findTileByPosition(static_cast<int>(tilePosition.x), static_cast<int>(tilePosition.y));
+}
+
+// Função para obter os dados de um tile
+// Nos mapas em streaming o tile é calculado a partir da grid, já que não há vetor de tiles; a textura vem do
+// pendingTileTexture(), que não lê células que a thread de desenho pode estar gravando
+bool Tilemap::getTile(int x, int y, Tile& tile) const {
+    if (!mapData.inBounds(x, y)) {
+        return false;
+    }
+    if (const Tile* found = findTileByPosition(x, y)) {
+        tile = *found;
+        return true;
     }
-    return nullptr;
+    tile = Tile{ tileWorldPosition(x, y), glm::vec3(x, y, 0.0f), pendingTileTexture(x, y) };
+    return true;
 }
 
-// Funo que desenha os tiles na tela
-void Tilemap::drawTiles() const {
- 
-    for (const Sprite& tile : tiles) {
-        tile.draw();
+// Função que calcula a posição no mundo do tile (x, y) em diamond view
+glm::vec3 Tilemap::tileWorldPosition(int x, int y) const {
+    glm::vec2 offset = getOffset();
+    float isoX = (x - y) * (TILE_SIZE / 2.0f);
+    float isoY = (x + y) * (TILE_SIZE / 4.0f);
+    return glm::vec3(isoX + offset.x, isoY + offset.y, 0.0f);
+}
+
+// Função que indica se o mapa usa streaming de chunks
+bool Tilemap::isStreaming() const {
+    return streamer != nullptr;
+}
+
+// Função que retorna a posição do tile (x, y) no vetor de tiles
+int Tilemap::tileSlot(int x, int y) const {
+    if (x < 0 || x >= mapWidth || y < 0 || y >= mapHeight || tileSlots.empty()) {
+        return -1;
     }
+    return tileSlots[y * mapWidth + x];
 }
 
-// Funo que checa se o tile permite o personagem andar nele
-bool Tilemap::isWalkable(int x, int y) const {
-    if (x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) {
-        return false;
+// Função que atualiza os chunks residentes de acordo com a câmera (nada a fazer em mapas pequenos)
+void Tilemap::update(const glm::vec3& cameraPos) {
+    if (streamer) {
+        streamer->update(visibleBounds(cameraPos));
     }
-    int tileIndex = mapData[y][x];
-    return std::find(nonWalkableTextures.begin(), nonWalkableTextures.end(), tileIndex) == nonWalkableTextures.end();
 }
 
-// Funo que carrega o tilemap
-void Tilemap::loadMap(const std::string& configPath) {
-    std::ifstream file(configPath);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open configuration file" << std::endl;
+// Função que desenha os tiles na tela
+void Tilemap::drawTiles() const {
+    if (streamer) {
+        streamer->draw(shader, tileset.get());
         return;
     }
+    renderer.draw(shader, tileset.get());
+}
 
-    std::string line;
+// Função que desenha somente os tiles que cruzam a tela
+// Inverte a transformação isométrica do loadMap (isoX = (x - y) * T/2, isoY = (x + y) * T/4) para achar,
+// em cada diagonal d = x + y visível, a faixa de colunas visível. Como os tiles estão ordenados por
+// diagonal e depois por x, cada faixa é contígua no buffer, e o custo depende da área da tela e não do mapa
+void Tilemap::drawTiles(const glm::vec3& cameraPos) const {
+    if (streamer) {
+        // Os chunks visíveis foram escolhidos no update()
+        streamer->draw(shader, tileset.get());
+        return;
+    }
+    if (tiles.empty()) {
+        return;
+    }
 
-    // L o caminho da textura
-    std::getline(file, line);
-    std::string texturePath = line;
+    IsoBounds visible = visibleBounds(cameraPos);
+    drawDiagonals(visible, visible.dMax, visible.dMin);
+}
 
-    // L o a quantidade de texturas diferentes
-    std::getline(file, line);
-    std::stringstream ss(line);
-    ss >> tileCount;
+// Função que desenha os tiles visíveis de um trecho de diagonais
+void Tilemap::drawDiagonals(const IsoBounds& visible, int dHigh, int dLow) const {
+    visibleRanges.clear();
+    int uMin = visible.uMin, uMax = visible.uMax;
+    int dMin = std::max({ 0, visible.dMin, dLow });
+    int dMax = std::min({ mapWidth + mapHeight - 2, visible.dMax, dHigh });
+
+    // Percorre as diagonais na ordem de pintura (da mais distante para a mais próxima)
+    for (int d = dMax; d >= dMin; --d) {
+        int x0 = std::max({ 0, d - (mapHeight - 1), static_cast<int>(std::ceil((d + uMin) / 2.0f)) });
+        int x1 = std::min({ mapWidth - 1, d, static_cast<int>(std::floor((d + uMax) / 2.0f)) });
+        if (x0 > x1) {
+            continue;
+        }
 
-    // L o valor da grid da spritesheet da textura
-    std::getline(file, line);
-    ss = std::stringstream(line);
-    ss >> tileColumns >> tileRows;
+        GLint first = tileSlot(x0, d - x0);
+        GLsizei count = x1 - x0 + 1;
 
-    // L o valor da grid do tilemap
-    std::getline(file, line);
-    ss = std::stringstream(line);
-    ss >> mapWidth >> mapHeight;
+        // Junta faixas vizinhas no buffer em uma única chamada de desenho
+        if (!visibleRanges.empty() && visibleRanges.back().first + visibleRanges.back().count == first) {
+            visibleRanges.back().count += count;
+        }
+        else {
+            visibleRanges.push_back(TileRange{ first, count });
+        }
+    }
 
-    // L o valor das texturas que no podem ser caminhadas
-    std::getline(file, line);
-    ss = std::stringstream(line);
-    int textureNumber;
-    while (ss >> textureNumber) {
-        nonWalkableTextures.push_back(textureNumber);
+    renderer.drawRanges(shader, tileset.get(), visibleRanges);
+}
+
+// Função que envia o desenho dos tiles para a fila do frame
+// As diagonais visíveis são cortadas logo depois de cada diagonal ocupada por uma entidade: a faixa que termina
+// na diagonal d recebe a profundidade dos tiles de d, e as entidades de d (ISO_SLOT_ENTITIES) caem entre ela e
+// a faixa seguinte. Assim um personagem atrás de uma parede é coberto por ela, com uma chamada de desenho por
+// faixa em vez de uma por tile. Mapas em streaming desenham por chunks e continuam como um único comando no
+// fundo; o teste de profundidade (tile.vs) ordena os tiles deles com as entidades
+void Tilemap::submit(RenderQueue& queue, const glm::vec3& cameraPos, const std::vector<int>* entityDiagonals) const {
+    submittedBounds = visibleBounds(cameraPos);
+    submittedBands.clear();
+    GLuint textureID = tileset ? tileset->getID() : 0;
+
+    int dMin = std::max(0, submittedBounds.dMin);
+    int dMax = std::min(mapWidth + mapHeight - 2, submittedBounds.dMax);
+    if (streamer || !entityDiagonals || dMin > dMax) {
+        submittedBands.push_back(TileBand{ this, submittedBounds.dMax, submittedBounds.dMin });
+        queue.submitCommand(RenderQueue::makeKey(RENDER_LAYER_WORLD, 0, shader.ID, textureID), &Tilemap::drawSubmitted, &submittedBands.back());
+        return;
     }
 
-    // Calcula o offset
+    // A fila guarda ponteiros para as faixas, então o vetor não pode crescer depois do primeiro envio
+    visibleDiagonals.clear();
+    for (int diagonal : *entityDiagonals) {
+        if (diagonal >= dMin && diagonal <= dMax) {
+            visibleDiagonals.push_back(diagonal);
+        }
+    }
+    submittedBands.reserve(visibleDiagonals.size() + 1);
+
+    int dHigh = dMax;
+    for (int diagonal : visibleDiagonals) {
+        submittedBands.push_back(TileBand{ this, dHigh, diagonal });
+        queue.submitCommand(RenderQueue::makeKey(RENDER_LAYER_WORLD, isoPainterDepth(diagonal, ISO_SLOT_TILES), shader.ID, textureID),
+            &Tilemap::drawSubmitted, &submittedBands.back());
+        dHigh = diagonal - 1;
+    }
+    if (dHigh >= dMin) {
+        submittedBands.push_back(TileBand{ this, dHigh, dMin });
+        queue.submitCommand(RenderQueue::makeKey(RENDER_LAYER_WORLD, isoPainterDepth(dMin, ISO_SLOT_TILES), shader.ID, textureID),
+            &Tilemap::drawSubmitted, &submittedBands.back());
+    }
+}
+
+// Função chamada pela fila para desenhar uma faixa de tiles
+void Tilemap::drawSubmitted(const void* band) {
+    const TileBand* tileBand = static_cast<const TileBand*>(band);
+    const Tilemap* self = tileBand->tilemap;
+    if (self->streamer) {
+        self->streamer->draw(self->shader, self->tileset.get());
+        return;
+    }
+    if (!self->tiles.empty()) {
+        self->drawDiagonals(self->submittedBounds, tileBand->dHigh, tileBand->dLow);
+    }
+}
+
+// Função que calcula a área visível em coordenadas isométricas
+// Retângulo da tela relativo à origem do mapa, com meio tile de margem para os quads que cruzam a borda,
+// convertido em u = x - y e d = x + y dos centros dos tiles que caem dentro dele
+IsoBounds Tilemap::visibleBounds(const glm::vec3& cameraPos) const {
     glm::vec2 offset = getOffset();
-    float offsetX = offset.x;
-    float offsetY = offset.y;
+    float margin = TILE_SIZE / 2.0f;
+    float minX = cameraPos.x - margin - offset.x;
+    float maxX = cameraPos.x + screenWidth + margin - offset.x;
+    float minY = cameraPos.y - margin - offset.y;
+    float maxY = cameraPos.y + screenHeight + margin - offset.y;
+
+    IsoBounds bounds;
+    bounds.uMin = static_cast<int>(std::ceil(minX / (TILE_SIZE / 2.0f)));
+    bounds.uMax = static_cast<int>(std::floor(maxX / (TILE_SIZE / 2.0f)));
+    bounds.dMin = static_cast<int>(std::ceil(minY / (TILE_SIZE / 4.0f)));
+    bounds.dMax = static_cast<int>(std::floor(maxY / (TILE_SIZE / 4.0f)));
+    return bounds;
+}
+
+// Função que envia os uniforms fixos do mapa ao shader dos tiles
+// Ficam guardados no programa e não precisam ser reenviados a cada frame
+void Tilemap::setupShader(glm::vec2 offset) {
+    shader.Use();
+    shader.setFloat("tileSize", TILE_SIZE);
+    shader.setVec2("mapOffset", offset.x, offset.y);
+    shader.setInt("tileColumns", tileColumns);
+    shader.setInt("tileRows", tileRows);
+    shader.setVec4("tileRect", tilesetRect.x, tilesetRect.y, tilesetRect.z, tilesetRect.w);
+}
 
-    mapData.resize(mapHeight, std::vector<int>(mapWidth));
+// Função que checa se o tile permite o personagem andar nele
+// As comparações sem sinal cobrem x < 0 e y < 0 com um único teste por eixo
+bool Tilemap::isWalkable(int x, int y) const {
+    if ((static_cast<unsigned>(x) >= static_cast<unsigned>(mapWidth)) | (static_cast<unsigned>(y) >= static_cast<unsigned>(mapHeight))) {
+        return false;
+    }
+    return (walkableBits[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1u;
+}
+
+// Função que checa uma faixa inteira de uma linha, 64 tiles por comparação
+bool Tilemap::isSpanWalkable(int y, int x0, int x1) const {
+    if (y < 0 || y >= mapHeight || x0 < 0 || x1 >= mapWidth || x0 > x1) {
+        return false;
+    }
+    const uint64_t* row = &walkableBits[y * wordsPerRow];
+    int firstWord = x0 >> 6;
+    int lastWord = x1 >> 6;
+    for (int word = firstWord; word <= lastWord; ++word) {
+        // Máscara com os bits da faixa que caem nesta palavra
+        uint64_t mask = ~0ull;
+        if (word == firstWord) {
+            mask &= ~0ull << (x0 & 63);
+        }
+        if (word == lastWord) {
+            mask &= ~0ull >> (63 - (x1 & 63));
+        }
+        if ((row[word] & mask) != mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Função para retornar as propriedades de um índice de textura
+const TileProperties& Tilemap::getTileProperties(int textureIndex) const {
+    static const TileProperties defaultProperties;
+    if (textureIndex < 0 || textureIndex >= static_cast<int>(tileProperties.size())) {
+        return defaultProperties;
+    }
+    return tileProperties[textureIndex];
+}
+
+// Função para reconstruir o bitset de caminhabilidade
+// Cada linha do mapa ocupa wordsPerRow palavras de 64 bits, assim uma linha pode ser testada palavra a palavra
+// As palavras são montadas em registrador a partir de uma tabela por índice de textura, sem ler e escrever
+// o bitset a cada célula, o que mantém o custo baixo mesmo em mapas de milhões de tiles
+void Tilemap::rebuildWalkability() {
+    std::vector<uint8_t> walkableByTexture(tileProperties.size());
+    for (size_t i = 0; i < tileProperties.size(); ++i) {
+        walkableByTexture[i] = tileProperties[i].walkable ? 1 : 0;
+    }
+
+    wordsPerRow = (mapWidth + 63) / 64;
+    walkableBits.assign(static_cast<size_t>(wordsPerRow) * mapHeight, 0);
     for (int y = 0; y < mapHeight; ++y) {
-        std::getline(file, line);
-        ss = std::stringstream(line);
+        const TileGrid::TileId* row = mapData.row(y);
+        uint64_t* words = &walkableBits[static_cast<size_t>(y) * wordsPerRow];
+        uint64_t word = 0;
         for (int x = 0; x < mapWidth; ++x) {
-            ss >> mapData[y][x];
+            // Índices sem entrada na tabela usam as propriedades padrão (caminhável)
+            uint64_t walkable = row[x] < walkableByTexture.size() ? walkableByTexture[row[x]] : 1;
+            word |= walkable << (x & 63);
+            if ((x & 63) == 63 || x == mapWidth - 1) {
+                words[x >> 6] = word;
+                word = 0;
+            }
+        }
+    }
+}
 
-            // Calcula a coordenada da textura 
-            int tileIndex = mapData[y][x];
-            int tileX = tileIndex % tileColumns;
-            int tileY = tileIndex / tileColumns;
+// Função para atualizar o bit de caminhabilidade de uma célula
+void Tilemap::setWalkableBit(int x, int y, bool walkable) {
+    uint64_t& word = walkableBits[y * wordsPerRow + (x >> 6)];
+    uint64_t bit = 1ull << (x & 63);
+    word = walkable ? (word | bit) : (word & ~bit);
+}
 
-            // Ajusta a posio dos tiles para diamond view
-            float isoX = (x - y) * (TILE_SIZE / 2.0f);
-            float isoY = (x + y) * (TILE_SIZE / 4.0f);
+// Função que carrega o tilemap
+// Aceita o formato texto (map.txt) e o binário (.gbmap), cuja grid é usada direto do arquivo mapeado em memória
+void Tilemap::loadMap(const std::string& configPath) {
+    MapDescription map;
+    bool loaded = isBinaryMapPath(configPath) ? loadBinaryMap(configPath, mapFile, map) : loadTextMap(configPath, map);
+    if (!loaded) {
+        return;
+    }
 
-            // Ajusta a posio com os offsets para centralizao
-            glm::vec3 position(isoX + offsetX, isoY + offsetY, 0.0f);
+    tileCount = map.tileCount;
+    tileColumns = map.tileColumns;
+    tileRows = map.tileRows;
 
-            // Posio do tile no mundo
-            glm::vec3 tilePosition(x, y, 0.0f);           
+    // Carrega a spritesheet uma única vez; todos os tiles compartilham a mesma textura do cache
+    if (tilesetMode == TILESET_ARRAY) {
+        // Uma camada por frame: o shader indexa a camada pelo índice de textura (tileArray.fs)
+        tileset = TextureCache::loadArray(map.texturePath, tileColumns, tileRows);
+    }
+    else {
+        // Se ela estiver em um atlas, o shader recebe a área dela na página e os sprites usam a mesma textura
+        TextureRegion region = TextureCache::loadRegion(map.texturePath);
+        tileset = region.texture;
+        tilesetRect = region.uvRect;
+    }
+    tileProperties = std::move(map.properties);
+    mapData = std::move(map.grid);
+    mapWidth = mapData.getWidth();
+    mapHeight = mapData.getHeight();
+
+    // Calcula o offset
+    glm::vec2 offset = getOffset();
 
-            // Cria o Sprite de tile
-            Sprite tile(shader, texturePath, position, tilePosition, glm::vec3(TILE_SIZE, TILE_SIZE, 1.0f), 0.0f);
-            tile.updateTextureCoordsStatic(tileColumns, tileRows, tileX, tileY);
-            tiles.emplace_back(std::move(tile));
+    // Mapas grandes não guardam um Tile por célula: os chunks são montados sob demanda a partir da grid
+    bool streaming = static_cast<long long>(mapWidth) * mapHeight > STREAMING_TILE_THRESHOLD;
+
+    if (!streaming) {
+        // Cria os tiles com a posição em diamond view; a geometria de todos os tiles é montada de uma vez pelo renderer
+        tiles.reserve(mapData.size());
+        for (int y = 0; y < mapHeight; ++y) {
+            for (int x = 0; x < mapWidth; ++x) {
+                tiles.push_back(Tile{ tileWorldPosition(x, y), glm::vec3(x, y, 0.0f), mapData(x, y) });
+            }
         }
     }
-    // Organiza os tiles baseado no valor Y para renderizao 
+
+    // Monta o bitset de caminhabilidade a partir da tabela de propriedades
+    rebuildWalkability();
+
+    // Envia ao shader o tamanho do tile, o offset e a grid da spritesheet
+    setupShader(offset);
+
+    if (streaming) {
+        streamer.reset(new TileChunkStreamer(mapData));
+        return;
+    }
+
+    // Organiza os tiles baseado no valor Y para renderização 
     sortTilesByPosition();
+
+    // Monta os buffers da camada já na ordem de pintura
+    renderer.build(tiles);
+}
+
+// Função para retornar os dados do mapa
+const TileGrid& Tilemap::getMapData() const {
+    return mapData;
 }
 
-// Funo para calcular o offset
+// Função para calcular o offset
 glm::vec2 Tilemap::getOffset() const {
     // Calcula o centro da tela e o centro do tilemap para centralizar o mapa
     float screenCenterX = screenWidth / 2.0f;
@@ -150,7 +392,7 @@ glm::vec2 Tilemap::getOffset() const {
     return glm::vec2(offsetX, offsetY);
 }
 
-// Funo para verificar as informaes dos Sprite tiles
+// Função para verificar as informações dos Sprite tiles
 void Tilemap::printTiles() const {
     for (const auto& tile : tiles) {
         glm::vec3 position = tile.getPosition();
@@ -160,69 +402,98 @@ void Tilemap::printTiles() const {
     }
 }
 
-// Funo para organizar os tiles pela posio Y
+// Função para organizar os tiles pela posição Y
+// A posição Y na tela depende só da diagonal x + y; dentro da mesma diagonal os tiles ficam em x crescente,
+// o que deixa cada trecho visível de uma diagonal contíguo no buffer de instâncias
 void Tilemap::sortTilesByPosition() {
-    std::sort(tiles.begin(), tiles.end(), [](const Sprite& a, const Sprite& b) {
-        return a.getPosition().y > b.getPosition().y;
+    std::sort(tiles.begin(), tiles.end(), [](const Tile& a, const Tile& b) {
+        int diagonalA = static_cast<int>(a.tilePosition.x + a.tilePosition.y);
+        int diagonalB = static_cast<int>(b.tilePosition.x + b.tilePosition.y);
+        if (diagonalA != diagonalB) {
+            return diagonalA > diagonalB;
+        }
+        return a.tilePosition.x < b.tilePosition.x;
         });
+
+    // A ordem mudou, então o índice (x, y) -> slot precisa ser refeito
+    rebuildTileSlots();
+}
+
+// Função para reconstruir o índice denso de busca dos tiles
+void Tilemap::rebuildTileSlots() {
+    tileSlots.assign(mapWidth * mapHeight, -1);
+    for (size_t slot = 0; slot < tiles.size(); ++slot) {
+        int x = static_cast<int>(tiles[slot].tilePosition.x);
+        int y = static_cast<int>(tiles[slot].tilePosition.y);
+        tileSlots[y * mapWidth + x] = static_cast<int>(slot);
+    }
 }
 
-// Funo para mudar a textura do tile
+// Função para mudar a textura do tile
+// Em mapas grandes a grid é compartilhada com a thread do streamer, então ela só muda no applyTileEdits(),
+// pelo TileChunkStreamer::setTile(), que a protege
 void Tilemap::changeTileTexture(int x, int y, int newTextureIndex) {
-    mapData[y][x] = newTextureIndex;
-    Sprite* tile = findSpriteByTilePosition(glm::vec3(x, y, 0.0f));
-    if (tile) {
-        int tileX = newTextureIndex % tileColumns;
-        int tileY = newTextureIndex / tileColumns;
-        tile->updateTextureCoordsStatic(tileColumns, tileRows, tileX, tileY);
-    }
-}
-
-// Funo para carregar a textura e retornar o ID da textura
-GLuint Tilemap::loadTexture(const std::string& texturePath) {
-    GLuint texID;
-
-    // Gera o identificador da textura na memria
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    // Configurao do parmetro WRAPPING nas coords s e t
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    // Configurao do parmetro FILTERING na minificao e magnificao da textura
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Atributos bsicos da imagem, largura, altura e nmero de canais de cores
-    int width, height, nrChannels;
-    // Habilita um flipagem vertical no carregamento da imagem
-    stbi_set_flip_vertically_on_load(true);
-    // Imagem
-    unsigned char* data = stbi_load(texturePath.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data) {
-        if (nrChannels == 3) { //jpg, bmp
-            // Texturiza a imagem com o RGB
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+    if (streamer) {
+        if (mapData.inBounds(x, y) && pendingTileTexture(x, y) != newTextureIndex) {
+            setWalkableBit(x, y, getTileProperties(newTextureIndex).walkable);
+            pendingTileEdits.push_back(TileEdit{ ++nextTileEditSequence, x, y, newTextureIndex });
         }
-        else { //png
-         // Texturiza a imagem com o RGBA
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        }
-        glGenerateMipmap(GL_TEXTURE_2D);
-        // Permite o PNG mesclar com o fundo caso tenha fundo nulo
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        return;
     }
-    else {
-        std::cerr << "Failed to load texture" << std::endl;
+
+    int slot = tileSlot(x, y);
+    if (slot < 0) {
+        return;
     }
+    mapData(x, y) = static_cast<TileGrid::TileId>(newTextureIndex);
+    setWalkableBit(x, y, getTileProperties(newTextureIndex).walkable);
+    if (tiles[slot].textureIndex != newTextureIndex) {
+        tiles[slot].textureIndex = newTextureIndex;
+        pendingTileEdits.push_back(TileEdit{ ++nextTileEditSequence, x, y, newTextureIndex });
+    }
+}
 
-    // Libera os dados da imagem
-    stbi_image_free(data);
-    // Desvincula a textura
-    glBindTexture(GL_TEXTURE_2D, 0);
+// Função que retorna a textura que o tile terá depois das trocas pendentes (mapas em streaming)
+// Enquanto uma troca do tile está pendente a thread de desenho pode estar gravando a grid, por isso a grid só é
+// lida quando não há nenhuma; as trocas confirmadas já saíram da lista depois de gravadas
+int Tilemap::pendingTileTexture(int x, int y) const {
+    for (auto it = pendingTileEdits.rbegin(); it != pendingTileEdits.rend(); ++it) {
+        if (it->x == x && it->y == y) {
+            return it->textureIndex;
+        }
+    }
+    return mapData(x, y);
+}
 
-    return texID;
-}
\ No newline at end of file
+// Função que copia as trocas ainda não confirmadas, descartando antes as que a GPU já aplicou
+void Tilemap::copyTileEdits(std::vector<TileEdit>& edits) {
+    uint64_t applied = appliedTileEdit.load(std::memory_order_acquire);
+    size_t confirmed = 0;
+    while (confirmed < pendingTileEdits.size() && pendingTileEdits[confirmed].sequence <= applied) {
+        ++confirmed;
+    }
+    pendingTileEdits.erase(pendingTileEdits.begin(), pendingTileEdits.begin() + confirmed);
+    edits.assign(pendingTileEdits.begin(), pendingTileEdits.end());
+}
+
+// Função que envia as trocas para a GPU
+// As trocas de frames descartados voltam no frame seguinte; o número de sequência evita aplicá-las duas vezes
+void Tilemap::applyTileEdits(const std::vector<TileEdit>& edits) {
+    uint64_t applied = appliedTileEdit.load(std::memory_order_relaxed);
+    for (const TileEdit& edit : edits) {
+        if (edit.sequence <= applied) {
+            continue;
+        }
+        if (streamer) {
+            streamer->setTile(edit.x, edit.y, static_cast<TileGrid::TileId>(edit.textureIndex));
+        }
+        else {
+            int slot = tileSlot(edit.x, edit.y);
+            if (slot >= 0) {
+                renderer.updateTile(slot, edit.textureIndex);
+            }
+        }
+        applied = edit.sequence;
+    }
+    appliedTileEdit.store(applied, std::memory_order_release);
+}
@@ -2,62 +2,172 @@
 #ifndef TILEMAP_H
 #define TILEMAP_H
 
-#include "Sprite.h"
+#include "Texture.h"
+#include "TilemapRenderer.h"
+#include "TileChunkStreamer.h"
+#include "TileProperties.h"
+#include "TileGrid.h"
+#include "MapFile.h"
+#include "RenderQueue.h"
+#include "IsoDepth.h"
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <memory>
+
+// Formas de guardar a spritesheet dos tiles na GPU
+enum TilesetMode {
+    TILESET_SHEET,      // Textura 2D (ou região de um atlas); o frame é recortado por UV no tile.vs, use com tex.fs
+    TILESET_ARRAY       // Textura array com uma camada por frame, sem vazamento entre frames e com mipmaps, use com tileArray.fs
+};
+
+// Troca de textura de um tile feita pela simulação, aguardando o envio para a GPU
+struct TileEdit {
+    uint64_t sequence;          // Número da troca, crescente; a GPU ignora trocas já aplicadas
+    int x, y;                   // Tile alterado
+    int textureIndex;           // Novo índice de textura
+};
 
 // Classe que representa o tilemap
+// Os dados do mapa (grid, caminhabilidade) pertencem à thread da simulação e os buffers da GPU à thread de
+// desenho: changeTileTexture() só altera os dados e guarda a troca, que chega à GPU pelo applyTileEdits()
 class Tilemap {
 public:
-    // Construtor que inicializa o tilemap com o shader, caminho do arquivo de configurao e dimenses da tela
-    Tilemap(Shader& shader, const std::string& configPath, float screenWidth, float screenHeight);
+    // Construtor que inicializa o tilemap com o shader, caminho do arquivo de configuração, dimensões da tela e a forma do tileset
+    Tilemap(Shader& shader, const std::string& configPath, float screenWidth, float screenHeight, TilesetMode tilesetMode = TILESET_SHEET);
 
-    // Mtodos para obter o nmero de linhas e colunas de tiles
+    // Métodos para obter o número de linhas e colunas de tiles
     int getTileRows() const;
     int getTileColumns() const;
 
-    // Mtodos para obter a largura e altura da tela
+    // Métodos para obter a largura e altura da tela
     float getScreenWidth() const;
     float getScreenHeight() const;
 
-    // Mtodo para desenhar os tiles
+    // Método para atualizar o streaming de chunks de mapas grandes a partir da posição da câmera
+    void update(const glm::vec3& cameraPos);
+
+    // Método para desenhar os tiles
     void drawTiles() const;
 
-    // Mtodo para verificar se um tile  caminhvel
+    // Método para desenhar somente os tiles visíveis pela câmera (cameraPos é o canto inferior esquerdo da tela no mundo)
+    void drawTiles(const glm::vec3& cameraPos) const;
+
+    // Método para enviar o desenho dos tiles visíveis à fila de desenho do frame, na camada do mundo
+    // Com 'entityDiagonals' (as diagonais ocupadas por entidades, em ordem de pintura, como dá o
+    // EntityDepthOrder::diagonalsInRange), os tiles são divididos em faixas intercaladas com as entidades;
+    // sem ele (modo com depth buffer), o mapa visível entra como um único comando
+    void submit(RenderQueue& queue, const glm::vec3& cameraPos, const std::vector<int>* entityDiagonals = nullptr) const;
+
+    // Método para verificar se um tile é caminhável (um teste de bit no bitset de caminhabilidade)
     bool isWalkable(int x, int y) const;
 
-    // Mtodo para obter o deslocamento dos tiles
+    // Método para verificar se todos os tiles da linha y entre x0 e x1 (inclusive) são caminháveis
+    bool isSpanWalkable(int y, int x0, int x1) const;
+
+    // Método para obter as propriedades de um tipo de tile pelo índice da textura
+    const TileProperties& getTileProperties(int textureIndex) const;
+
+    // Método para obter os índices de textura de todas as células do mapa
+    const TileGrid& getMapData() const;
+
+    // Método para obter o deslocamento dos tiles
     glm::vec2 getOffset() const;
 
-    // Mtodo para encontrar um sprite pela posio do tile
-    Sprite* findSpriteByTilePosition(const glm::vec3& tilePosition);
+    // Métodos para encontrar um tile pela sua posição na grid em tempo constante
+    // Em mapas grandes (streaming) os tiles não ficam em memória e estes métodos retornam nullptr
+    const Tile* findTileByPosition(int x, int y) const;
+    const Tile* findTileByPosition(const glm::vec3& tilePosition) const;
+
+    // Método para obter os dados de um tile em qualquer modo; retorna false se (x, y) estiver fora do mapa
+    bool getTile(int x, int y, Tile& tile) const;
+
+    // Método que calcula a posição no mundo do centro do tile (x, y)
+    glm::vec3 tileWorldPosition(int x, int y) const;
 
-    // Mtodo para mudar a textura de um tile
+    // Método que indica se o mapa é desenhado por chunks sob demanda
+    bool isStreaming() const;
+
+    // Método para mudar a textura de um tile; atualiza os dados do mapa na hora e guarda a troca para a GPU
     void changeTileTexture(int x, int y, int newTextureIndex);
 
-    // Mtodo para imprimir os tiles (usado para depurao)
+    // Copia para 'edits' as trocas que a GPU ainda não confirmou (thread da simulação)
+    // Uma troca só sai da lista depois de aplicada, então um frame descartado não perde trocas
+    void copyTileEdits(std::vector<TileEdit>& edits);
+
+    // Envia para a GPU as trocas ainda não aplicadas (thread de desenho)
+    void applyTileEdits(const std::vector<TileEdit>& edits);
+
+    // Método para imprimir os tiles (usado para depuração)
     void printTiles() const;
 
 private:
-    // Mtodo para carregar o mapa a partir de um arquivo de configurao
+    // Método para carregar o mapa a partir de um arquivo de configuração
     void loadMap(const std::string& configPath);
 
-    // Mtodo para carregar uma textura a partir de um caminho de arquivo
-    GLuint loadTexture(const std::string& texturePath);
+    // Método para enviar ao shader dos tiles os uniforms fixos do mapa
+    void setupShader(glm::vec2 offset);
+
+    // Faixa de diagonais visíveis enviada à RenderQueue como um comando
+    struct TileBand {
+        const Tilemap* tilemap;
+        int dHigh, dLow;        // Diagonais da faixa, da mais distante para a mais próxima (inclusive)
+    };
+
+    // Comando da RenderQueue: desenha uma faixa de diagonais dentro da área guardada no submit()
+    static void drawSubmitted(const void* band);
+
+    // Método que desenha os tiles visíveis das diagonais dHigh até dLow
+    void drawDiagonals(const IsoBounds& visible, int dHigh, int dLow) const;
 
-    // Mtodo para ordenar os tiles pela posio
+    // Método que calcula a área isométrica visível pela câmera
+    IsoBounds visibleBounds(const glm::vec3& cameraPos) const;
+
+    // Método para ordenar os tiles pela posição
     void sortTilesByPosition();
 
-    Shader& shader;                             // Referncia ao shader
-    std::vector<Sprite> tiles;                  // Vetor de sprites dos tiles
-    std::vector<std::vector<int>> mapData;      // Dados do mapa
-    std::vector<int> nonWalkableTextures;       // Vetor de texturas no caminhveis
+    // Método para reconstruir o índice (x, y) -> posição do tile no vetor de tiles
+    void rebuildTileSlots();
+
+    // Método que retorna a posição do tile no vetor de tiles, ou -1 se (x, y) estiver fora do mapa
+    int tileSlot(int x, int y) const;
+
+    // Método para reconstruir o bitset de caminhabilidade a partir dos dados do mapa
+    void rebuildWalkability();
+
+    // Método para atualizar o bit de caminhabilidade de uma única célula
+    void setWalkableBit(int x, int y, bool walkable);
+
+    // Método que retorna a textura do tile contando as trocas ainda não aplicadas (mapas em streaming)
+    int pendingTileTexture(int x, int y) const;
+
+    Shader& shader;                             // Referência ao shader dos tiles (tile.vs)
+    TilesetMode tilesetMode;                    // Textura 2D ou textura array
+    TextureHandle tileset;                      // Textura da spritesheet compartilhada pelos tiles (a página do atlas, se empacotada)
+    glm::vec4 tilesetRect;                      // Área da spritesheet na textura: offset (xy) e tamanho (zw)
+    std::vector<Tile> tiles;                    // Vetor de tiles em ordem de pintura
+    std::vector<int> tileSlots;                 // Índice denso (x, y) -> posição do tile em 'tiles'
+    TilemapRenderer renderer;                   // Renderer que desenha todos os tiles com uma chamada
+    mutable std::vector<TileRange> visibleRanges;   // Faixas visíveis do último frame (reaproveita a memória)
+    mutable IsoBounds submittedBounds;          // Área visível do último submit(), usada quando a fila desenha os tiles
+    mutable std::vector<TileBand> submittedBands;   // Faixas do último submit(); a fila guarda ponteiros para elas até o flush()
+    mutable std::vector<int> visibleDiagonals;  // Diagonais visíveis ocupadas por entidades (reaproveita a memória)
+    std::vector<TileEdit> pendingTileEdits;     // Trocas de textura ainda não confirmadas pela GPU
+    uint64_t nextTileEditSequence;              // Número da próxima troca
+    std::atomic<uint64_t> appliedTileEdit;      // Última troca aplicada na GPU, escrita pela thread de desenho
+    MappedFile mapFile;                         // Arquivo de mapa binário mapeado em memória (declarado antes de mapData, que aponta para ele)
+    TileGrid mapData;                           // Dados do mapa (índices de textura em um buffer contíguo)
+    std::unique_ptr<TileChunkStreamer> streamer;    // Streaming de chunks em mapas grandes (declarado após mapData, que ele referencia)
+    std::vector<TileProperties> tileProperties; // Propriedades de cada índice de textura
+    std::vector<uint64_t> walkableBits;         // Bitset de caminhabilidade, uma linha do mapa a cada wordsPerRow palavras
+    int wordsPerRow;                            // Palavras de 64 bits por linha do bitset
     int mapWidth, mapHeight;                    // Largura e altura do mapa
     int tileCount;                              // Contagem de tiles
-    int tileRows, tileColumns;                  // Nmero de linhas e colunas de tiles
+    int tileRows, tileColumns;                  // Número de linhas e colunas de tiles
     float screenWidth, screenHeight;            // Largura e altura da tela
 };
 
@@ -0,0 +1,97 @@
+#include "TilemapRenderer.h"
+#include "RenderState.h"
+#include "SharedQuad.h"
+#include <cstddef>
+
+// Construtor da classe TilemapRenderer
+TilemapRenderer::TilemapRenderer()
+    : VAO(0), instanceVBO(0), instanceCount(0) {
+}
+
+// Destrutor: libera os buffers somente se ainda houver um contexto OpenGL ativo
+TilemapRenderer::~TilemapRenderer() {
+    if (VAO != 0 && glfwGetCurrentContext() != nullptr) {
+        glDeleteVertexArrays(1, &VAO);
+        RenderState::vertexArrayDeleted(VAO);
+        glDeleteBuffers(1, &instanceVBO);
+    }
+    if (VAO != 0) {
+        SharedQuad::release();
+    }
+}
+
+// Função que monta o quad compartilhado e o buffer de instâncias da camada
+void TilemapRenderer::build(const std::vector<Tile>& tiles) {
+    std::vector<TileInstance> instances;
+    instances.reserve(tiles.size());
+    for (const Tile& tile : tiles) {
+        instances.push_back(TileInstance{
+            static_cast<uint16_t>(tile.tilePosition.x),
+            static_cast<uint16_t>(tile.tilePosition.y),
+            static_cast<uint16_t>(tile.textureIndex),
+            0 });
+    }
+    instanceCount = static_cast<GLsizei>(instances.size());
+
+    if (VAO == 0) {
+        SharedQuad::acquire();
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &instanceVBO);
+
+        RenderState::bindVertexArray(VAO);                                                  // Vincula o VAO
+        SharedQuad::attach();                                                               // Quad unitário compartilhado
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);                                         // (x, y, textura) de cada tile
+        glVertexAttribIPointer(3, 3, GL_UNSIGNED_SHORT, sizeof(TileInstance), (GLvoid*)0);
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);                                                        // Avança uma vez por instância
+
+        RenderState::bindVertexArray(0);                                                    // Desassocia o VAO
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(TileInstance), instances.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);                                                       // Desassocia o buffer de vértices
+}
+
+// Função que troca o índice de textura de um único tile no buffer de instâncias
+void TilemapRenderer::updateTile(size_t slot, int textureIndex) {
+    uint16_t index = static_cast<uint16_t>(textureIndex);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, slot * sizeof(TileInstance) + offsetof(TileInstance, textureIndex), sizeof(index), &index);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Função que desenha a camada inteira com uma chamada de desenho
+void TilemapRenderer::draw(Shader& shader, const Texture* texture) const {
+    TileRange whole{ 0, instanceCount };
+    drawRangeList(shader, texture, &whole, 1);
+}
+
+// Função que desenha faixas do buffer de instâncias
+void TilemapRenderer::drawRanges(Shader& shader, const Texture* texture, const std::vector<TileRange>& ranges) const {
+    drawRangeList(shader, texture, ranges.data(), ranges.size());
+}
+
+// Função que desenha uma lista de faixas
+// A OpenGL 3.3 não tem baseInstance, então o início de cada faixa é definido
+// deslocando o ponteiro do atributo de instância antes da chamada de desenho
+void TilemapRenderer::drawRangeList(Shader& shader, const Texture* texture, const TileRange* ranges, size_t count) const {
+    if (instanceCount == 0 || count == 0) {
+        return;
+    }
+
+    shader.Use();
+    if (texture) {
+        texture->bind();
+    }
+    RenderState::bindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (size_t i = 0; i < count; ++i) {
+        const TileRange& range = ranges[i];
+        glVertexAttribIPointer(3, 3, GL_UNSIGNED_SHORT, sizeof(TileInstance), (GLvoid*)(range.first * sizeof(TileInstance)));
+        glDrawElementsInstanced(GL_TRIANGLES, SharedQuad::INDEX_COUNT, SharedQuad::INDEX_TYPE, 0, range.count);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,83 @@
+#ifndef TILEMAPRENDERER_H
+#define TILEMAPRENDERER_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "Shader.h"
+#include "Texture.h"
+
+// Dados de um tile do mapa: posição no mundo, posição na grid e índice da textura na spritesheet
+struct Tile {
+    glm::vec3 position;         // Posição do tile no mundo (diamond view)
+    glm::vec3 tilePosition;     // Posição do tile na grid do mapa
+    int textureIndex;           // Índice do tile na spritesheet
+
+    // Retorna a posição do tile no mundo
+    glm::vec3 getPosition() const { return position; }
+
+    // Retorna a posição do tile na grid
+    glm::vec3 getTilePosition() const { return tilePosition; }
+};
+
+// Dados de um tile enviados para a GPU: 8 bytes por tile
+// O shader tile.vs calcula a posição isométrica e as coordenadas de textura a partir deles
+struct TileInstance {
+    uint16_t x;                 // Coluna do tile na grid
+    uint16_t y;                 // Linha do tile na grid
+    uint16_t textureIndex;      // Índice do tile na spritesheet
+    uint16_t padding;           // Mantém o tamanho em 8 bytes
+};
+
+// Faixa contígua de slots do buffer de instâncias
+struct TileRange {
+    GLint first;                // Primeiro slot da faixa
+    GLsizei count;              // Quantidade de slots
+};
+
+// Área do mapa em coordenadas isométricas: u = x - y (coluna na tela) e d = x + y (diagonal / linha na tela)
+struct IsoBounds {
+    int uMin, uMax;             // Faixa de u (inclusive)
+    int dMin, dMax;             // Faixa de d (inclusive)
+};
+
+// Classe que desenha todos os tiles de uma camada com uma única chamada de desenho instanciada
+// Um quad unitário é compartilhado por todos os tiles e cada instância (x, y, textura) fica
+// em um buffer estático, já na ordem de pintura
+class TilemapRenderer {
+public:
+    // Construtor: não cria recursos na GPU até o primeiro build()
+    TilemapRenderer();
+
+    // Libera os buffers da GPU
+    ~TilemapRenderer();
+
+    // Os buffers têm um único dono, por isso o renderer não pode ser copiado
+    TilemapRenderer(const TilemapRenderer&) = delete;
+    TilemapRenderer& operator=(const TilemapRenderer&) = delete;
+
+    // Monta o buffer de instâncias a partir dos tiles, na ordem em que estão no vetor
+    void build(const std::vector<Tile>& tiles);
+
+    // Atualiza o índice de textura do tile que ocupa a posição 'slot' no buffer (2 bytes enviados)
+    void updateTile(size_t slot, int textureIndex);
+
+    // Desenha todos os tiles com uma chamada de desenho
+    void draw(Shader& shader, const Texture* texture) const;
+
+    // Desenha somente as faixas de slots informadas, na ordem do vetor (uma chamada por faixa)
+    void drawRanges(Shader& shader, const Texture* texture, const std::vector<TileRange>& ranges) const;
+
+    // Retorna a quantidade de tiles no buffer de instâncias
+    GLsizei getInstanceCount() const { return instanceCount; }
+
+private:
+    // Desenha 'count' faixas a partir de 'ranges'; usado pelo draw() com uma faixa na pilha, sem alocar
+    void drawRangeList(Shader& shader, const Texture* texture, const TileRange* ranges, size_t count) const;
+
+    GLuint VAO;                 // Vertex Array Object da camada
+    GLuint instanceVBO;         // Buffer com um TileInstance por tile
+    GLsizei instanceCount;      // Quantidade de tiles desenhados
+};
+
+#endif
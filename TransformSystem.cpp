@@ -0,0 +1,220 @@
+#include "TransformSystem.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define TRANSFORM_SYSTEM_SSE
+#endif
+
+const size_t TransformSystem::BLOCK_SIZE;
+
+std::vector<float> TransformSystem::positionX, TransformSystem::positionY;
+std::vector<float> TransformSystem::scaleX, TransformSystem::scaleY;
+std::vector<float> TransformSystem::rotation;
+std::vector<float> TransformSystem::cosine, TransformSystem::sine;
+std::vector<float> TransformSystem::previousX, TransformSystem::previousY;
+std::vector<float> TransformSystem::matrixA, TransformSystem::matrixB, TransformSystem::matrixC, TransformSystem::matrixD;
+std::vector<float> TransformSystem::translationX, TransformSystem::translationY;
+std::vector<uint8_t> TransformSystem::dirty;
+std::vector<uint8_t> TransformSystem::moving;
+std::vector<int> TransformSystem::movedHandles;
+std::vector<uint8_t> TransformSystem::active;
+std::vector<int> TransformSystem::freeHandles;
+size_t TransformSystem::count = 0;
+size_t TransformSystem::dirtyCount = 0;
+size_t TransformSystem::lastUpdateCount = 0;
+
+// Função que registra uma entidade
+int TransformSystem::create(glm::vec2 position, glm::vec2 scale, float degrees) {
+    int handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+    else {
+        handle = static_cast<int>(count++);
+
+        // Os vetores crescem um bloco inteiro por vez; as entidades do fim do bloco ficam inativas e zeradas
+        if (count > active.size()) {
+            size_t capacity = active.size() + BLOCK_SIZE;
+            for (std::vector<float>* field : { &positionX, &positionY, &scaleX, &scaleY, &rotation, &cosine, &sine,
+                &previousX, &previousY, &matrixA, &matrixB, &matrixC, &matrixD, &translationX, &translationY }) {
+                field->resize(capacity, 0.0f);
+            }
+            dirty.resize(capacity, 0);
+            moving.resize(capacity, 0);
+            active.resize(capacity, 0);
+        }
+    }
+
+    // Uma entidade nova aparece direto na posição, sem interpolar a partir da anterior do identificador
+    active[handle] = 1;
+    positionX[handle] = previousX[handle] = position.x;
+    positionY[handle] = previousY[handle] = position.y;
+    scaleX[handle] = scale.x;
+    scaleY[handle] = scale.y;
+    rotation[handle] = degrees;
+    cosine[handle] = std::cos(glm::radians(degrees));
+    sine[handle] = std::sin(glm::radians(degrees));
+    if (!dirty[handle]) {
+        dirty[handle] = 1;
+        ++dirtyCount;
+    }
+    return handle;
+}
+
+// Função que remove uma entidade
+void TransformSystem::destroy(int handle) {
+    if (handle < 0 || handle >= static_cast<int>(count) || !active[handle]) {
+        return;
+    }
+    active[handle] = 0;
+    freeHandles.push_back(handle);
+}
+
+// Função que guarda a transformação de uma entidade, marcando-a como suja somente se ela mudou
+void TransformSystem::set(int handle, glm::vec2 position, glm::vec2 scale, float degrees) {
+    if (handle < 0 || handle >= static_cast<int>(count) || !active[handle]) {
+        return;
+    }
+
+    bool changed = false;
+    if (positionX[handle] != position.x || positionY[handle] != position.y) {
+        // A primeira mudança no passo guarda a posição de partida (previous já é igual à posição atual)
+        if (!moving[handle]) {
+            moving[handle] = 1;
+            movedHandles.push_back(handle);
+        }
+        positionX[handle] = position.x;
+        positionY[handle] = position.y;
+        changed = true;
+    }
+    if (scaleX[handle] != scale.x || scaleY[handle] != scale.y) {
+        scaleX[handle] = scale.x;
+        scaleY[handle] = scale.y;
+        changed = true;
+    }
+    if (rotation[handle] != degrees) {
+        // Seno e cosseno só quando a rotação muda: a conta em lote do update() fica só com multiplicações
+        rotation[handle] = degrees;
+        cosine[handle] = std::cos(glm::radians(degrees));
+        sine[handle] = std::sin(glm::radians(degrees));
+        changed = true;
+    }
+
+    if (changed && !dirty[handle]) {
+        dirty[handle] = 1;
+        ++dirtyCount;
+    }
+}
+
+// Função que começa um passo da simulação
+// As entidades que andaram no passo anterior passam a partir da posição em que ele terminou; as que não andarem
+// neste passo ficam sujas uma última vez, para a translação parar exatamente na posição final
+void TransformSystem::beginTick() {
+    for (int handle : movedHandles) {
+        previousX[handle] = positionX[handle];
+        previousY[handle] = positionY[handle];
+        moving[handle] = 0;
+        if (!dirty[handle]) {
+            dirty[handle] = 1;
+            ++dirtyCount;
+        }
+    }
+    movedHandles.clear();
+}
+
+// Função que recalcula as matrizes das entidades sujas ou em movimento, um bloco de BLOCK_SIZE por vez
+void TransformSystem::update(float alpha) {
+    if (!hasPendingUpdate()) {
+        lastUpdateCount = 0;
+        return;
+    }
+    finishUpdate(updateBlocks(0, getBlockCount(), alpha));
+}
+
+// Função que indica se alguma entidade precisa ser recalculada
+bool TransformSystem::hasPendingUpdate() {
+    return dirtyCount != 0 || !movedHandles.empty();
+}
+
+// Função para retornar a quantidade de blocos
+size_t TransformSystem::getBlockCount() {
+    return (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+}
+
+// Função que recalcula uma faixa de blocos
+// Os BLOCK_SIZE bits de sujo e de movimento de um bloco são testados juntos como inteiros de 32 bits
+// Cada bloco só escreve nas próprias posições dos vetores, então faixas diferentes podem rodar em paralelo
+size_t TransformSystem::updateBlocks(size_t firstBlock, size_t lastBlock, float alpha) {
+    static_assert(BLOCK_SIZE == sizeof(uint32_t), "the dirty flags of a block are tested as one uint32_t");
+    size_t updated = 0;
+    for (size_t first = firstBlock * BLOCK_SIZE; first < lastBlock * BLOCK_SIZE; first += BLOCK_SIZE) {
+        uint32_t blockDirty, blockMoving;
+        std::memcpy(&blockDirty, &dirty[first], sizeof(blockDirty));
+        std::memcpy(&blockMoving, &moving[first], sizeof(blockMoving));
+        if ((blockDirty | blockMoving) != 0) {
+            updateBlock(first, alpha);
+            for (size_t i = first; i < first + BLOCK_SIZE; ++i) {
+                updated += (dirty[i] | moving[i]) != 0 ? 1 : 0;
+            }
+            std::memset(&dirty[first], 0, BLOCK_SIZE);
+        }
+    }
+    return updated;
+}
+
+// Função que fecha um update() feito por faixas
+void TransformSystem::finishUpdate(size_t updatedCount) {
+    lastUpdateCount = updatedCount;
+    dirtyCount = 0;
+}
+
+// Função que recalcula um bloco: matriz = translação * rotação * escala, a mesma ordem do glm usada antes
+// a =  cos * sx    b = -sin * sy    tx = previousX + (positionX - previousX) * alpha
+// c =  sin * sx    d =  cos * sy    ty = previousY + (positionY - previousY) * alpha
+// Entidades limpas do bloco são recalculadas junto e dão o mesmo resultado (nelas previous é igual à posição)
+void TransformSystem::updateBlock(size_t first, float alpha) {
+#ifdef TRANSFORM_SYSTEM_SSE
+    __m128 cosines = _mm_loadu_ps(&cosine[first]);
+    __m128 sines = _mm_loadu_ps(&sine[first]);
+    __m128 scalesX = _mm_loadu_ps(&scaleX[first]);
+    __m128 scalesY = _mm_loadu_ps(&scaleY[first]);
+    __m128 negativeSines = _mm_sub_ps(_mm_setzero_ps(), sines);
+    _mm_storeu_ps(&matrixA[first], _mm_mul_ps(cosines, scalesX));
+    _mm_storeu_ps(&matrixB[first], _mm_mul_ps(negativeSines, scalesY));
+    _mm_storeu_ps(&matrixC[first], _mm_mul_ps(sines, scalesX));
+    _mm_storeu_ps(&matrixD[first], _mm_mul_ps(cosines, scalesY));
+
+    __m128 alphas = _mm_set1_ps(alpha);
+    __m128 fromX = _mm_loadu_ps(&previousX[first]);
+    __m128 fromY = _mm_loadu_ps(&previousY[first]);
+    __m128 toX = _mm_loadu_ps(&positionX[first]);
+    __m128 toY = _mm_loadu_ps(&positionY[first]);
+    _mm_storeu_ps(&translationX[first], _mm_add_ps(fromX, _mm_mul_ps(_mm_sub_ps(toX, fromX), alphas)));
+    _mm_storeu_ps(&translationY[first], _mm_add_ps(fromY, _mm_mul_ps(_mm_sub_ps(toY, fromY), alphas)));
+#else
+    for (size_t i = first; i < first + BLOCK_SIZE; ++i) {
+        matrixA[i] = cosine[i] * scaleX[i];
+        matrixB[i] = -sine[i] * scaleY[i];
+        matrixC[i] = sine[i] * scaleX[i];
+        matrixD[i] = cosine[i] * scaleY[i];
+        translationX[i] = previousX[i] + (positionX[i] - previousX[i]) * alpha;
+        translationY[i] = previousY[i] + (positionY[i] - previousY[i]) * alpha;
+    }
+#endif
+}
+
+// Função que monta a matriz da entidade a partir dos vetores
+Affine2D TransformSystem::getMatrix(int handle) {
+    if (handle < 0 || handle >= static_cast<int>(count)) {
+        return Affine2D{ 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    }
+    return Affine2D{ matrixA[handle], matrixB[handle], matrixC[handle], matrixD[handle], translationX[handle], translationY[handle] };
+}
+
+// Função para retornar a quantidade de entidades ativas
+size_t TransformSystem::size() {
+    return count - freeHandles.size();
+}
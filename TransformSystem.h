@@ -0,0 +1,85 @@
+#ifndef TRANSFORMSYSTEM_H
+#define TRANSFORMSYSTEM_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Matriz afim 2x3 de um sprite: a parte linear (a, b na linha x; c, d na linha y) e a translação (tx, ty)
+// x' = a * x + b * y + tx
+// y' = c * x + d * y + ty
+struct Affine2D {
+    float a, b, c, d;
+    float tx, ty;
+};
+
+// Sistema que guarda as transformações de todos os sprites em estrutura de arrays
+// Cada campo (posição, escala, seno e cosseno da rotação, matriz) fica em um vetor próprio, e cada entidade tem
+// um bit de sujo. O update() só recalcula os blocos de 4 entidades que têm alguma entidade suja, 4 de cada
+// vez com SSE, e as entidades paradas não custam nada além do teste do bit
+// A simulação roda em passos fixos (beginTick() no início de cada passo). A translação desenhada é interpolada
+// entre a posição do fim do passo anterior e a do último passo; escala e rotação mudam direto no passo
+class TransformSystem {
+public:
+    static const size_t BLOCK_SIZE = 4;     // Entidades por bloco do update() (largura do registrador SSE)
+
+    // Registra uma entidade e retorna o identificador dela; a rotação é em graus, como no Sprite
+    static int create(glm::vec2 position, glm::vec2 scale, float rotation);
+
+    // Remove a entidade; o identificador pode ser reaproveitado por um create() seguinte
+    static void destroy(int handle);
+
+    // Informa a transformação atual da entidade; só a marca como suja se algum valor mudou
+    static void set(int handle, glm::vec2 position, glm::vec2 scale, float rotation);
+
+    // Começa um passo da simulação: as entidades que andaram no passo anterior fixam a posição de partida
+    static void beginTick();
+
+    // Recalcula as matrizes das entidades sujas e das que andaram no último passo, com a translação interpolada
+    // por 'alpha' (0 = posição no início do passo, 1 = no fim); deve ser chamado uma vez por frame, antes do
+    // envio dos sprites
+    static void update(float alpha = 1.0f);
+
+    // O mesmo update() dividido em faixas de blocos [firstBlock, lastBlock), para rodar em várias threads
+    // hasPendingUpdate() diz se há alguma entidade suja ou em movimento (sem nenhuma, o update() não faz nada)
+    // updateBlocks() retorna as entidades recalculadas na faixa; finishUpdate() recebe a soma de todas as faixas
+    static bool hasPendingUpdate();
+    static size_t getBlockCount();
+    static size_t updateBlocks(size_t firstBlock, size_t lastBlock, float alpha);
+    static void finishUpdate(size_t updatedCount);
+
+    // Retorna a matriz da entidade calculada no último update()
+    static Affine2D getMatrix(int handle);
+
+    // Métodos para obter a quantidade de entidades e de entidades recalculadas no último update()
+    static size_t size();
+    static size_t getLastUpdateCount() { return lastUpdateCount; }
+
+private:
+    // Recalcula as matrizes de um bloco de BLOCK_SIZE entidades a partir de 'first'
+    static void updateBlock(size_t first, float alpha);
+
+    // Campos de entrada, um vetor por campo, com tamanho múltiplo de BLOCK_SIZE
+    static std::vector<float> positionX, positionY;
+    static std::vector<float> scaleX, scaleY;
+    static std::vector<float> rotation;                 // Rotação em graus, para comparar no set()
+    static std::vector<float> cosine, sine;             // Calculados no set(), só quando a rotação muda
+
+    static std::vector<float> previousX, previousY;     // Posição no início do passo (igual à atual em entidades paradas)
+
+    // Matriz calculada no update(): parte linear e translação interpolada
+    static std::vector<float> matrixA, matrixB, matrixC, matrixD;
+    static std::vector<float> translationX, translationY;
+
+    static std::vector<uint8_t> dirty;                  // Se a entidade mudou desde o último update()
+    static std::vector<uint8_t> moving;                 // Se a posição mudou no passo atual (interpolada a cada frame)
+    static std::vector<int> movedHandles;               // Entidades com 'moving' ligado
+    static std::vector<uint8_t> active;                 // Se o identificador está em uso
+    static std::vector<int> freeHandles;                // Identificadores liberados para reuso
+    static size_t count;                                // Identificadores já usados (os vetores têm count arredondado para cima)
+    static size_t dirtyCount;                           // Entidades sujas desde o último update()
+    static size_t lastUpdateCount;                      // Entidades recalculadas no último update()
+};
+
+#endif
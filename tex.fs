@@ -4,10 +4,13 @@ in vec3 vertexColor;
 in vec2 texcoord;
 
 uniform sampler2D texBuffer;
+uniform float alphaCutoff;	// Com o teste de profundidade ligado, pixels transparentes não podem gravar profundidade
 
 out vec4 color;
 void main()
 {
 	color = texture(texBuffer, texcoord);//vec4(vertexColor,1.0);
+	if (color.a < alphaCutoff)
+		discard;
 
 }
\ No newline at end of file
@@ -1,20 +1,28 @@
 #version 400
 
-layout (location = 0) in vec3 position;
-layout (location = 1) in vec3 color;
-layout (location = 2) in vec2 texc;
+layout (location = 0) in vec2 quadCorner;  // Canto do quad compartilhado (-1 ou 1, SharedQuad)
+layout (location = 4) in vec2 translation; // Por instância: translação da matriz de modelo
+layout (location = 5) in vec4 linear;      // Por instância: parte linear da matriz (a, b, c, d), em half float
+layout (location = 6) in vec4 uvRect;      // Por instância: offset (xy) e tamanho (zw) do frame na spritesheet (16 bits normalizados)
+layout (location = 7) in float depth;      // Por instância: z do sprite (isoDepthZ), usado com o teste de profundidade
 
 out vec3 vertexColor;
 out vec2 texcoord;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
+// Matrizes da câmera, compartilhadas por todos os shaders (CameraBuffer)
+layout (std140) uniform Camera
+{
+	mat4 projection;
+	mat4 view;
+};
 
 void main()
 {
-	vertexColor = color;
-	texcoord = texc;
-	//...pode ter mais linhas de cdigo aqui!
-	gl_Position = projection * view * model * vec4(position, 1.0);
-}
\ No newline at end of file
+	// Aplica a matriz afim 2x3 do sprite ao canto do quad
+	vec2 corner = quadCorner * 0.5;
+	vec2 world = vec2(dot(linear.xy, corner), dot(linear.zw, corner)) + translation;
+
+	vertexColor = vec3(1.0);
+	texcoord = uvRect.xy + (corner + 0.5) * uvRect.zw;
+	gl_Position = projection * view * vec4(world, depth, 1.0);
+}
@@ -0,0 +1,50 @@
+#version 400
+
+layout (location = 0) in vec2 quadCorner;  // Canto do quad compartilhado (-1 ou 1, SharedQuad)
+layout (location = 3) in uvec3 tile;       // Por instância: x e y na grid e índice da textura
+
+out vec3 vertexColor;
+out vec2 texcoord;          // Coordenada na spritesheet (tex.fs)
+out vec2 layerCoord;        // Coordenada dentro do frame, na camada da textura array (tileArray.fs)
+flat out float layer;       // Camada da textura array: o próprio índice de textura do tile
+
+// Matrizes da câmera, compartilhadas por todos os shaders (CameraBuffer)
+layout (std140) uniform Camera
+{
+	mat4 projection;
+	mat4 view;
+};
+
+uniform float tileSize;     // Tamanho do tile em pixels
+uniform vec2 mapOffset;     // Offset de centralização do mapa
+uniform int tileColumns;    // Colunas da spritesheet
+uniform int tileRows;       // Linhas da spritesheet
+uniform vec4 tileRect;      // Área da spritesheet na textura: offset (xy) e tamanho (zw); (0, 0, 1, 1) sem atlas
+
+// Mesma conta de isoPainterDepth/isoDepthZ (IsoDepth.h) para ISO_SLOT_TILES
+const float ISO_MAX_DIAGONAL = 131070.0;
+const float ISO_SLOTS_PER_DIAGONAL = 4.0;
+
+void main()
+{
+	vec2 corner = quadCorner * 0.5;
+
+	// Posição isométrica do centro do tile (diamond view), igual à do Tilemap::loadMap
+	float x = float(tile.x);
+	float y = float(tile.y);
+	vec2 center = vec2((x - y) * (tileSize / 2.0), (x + y) * (tileSize / 4.0)) + mapOffset;
+
+	// Frame do tile na spritesheet
+	vec2 frameSize = vec2(1.0 / float(tileColumns), 1.0 / float(tileRows));
+	vec2 frame = vec2(float(tile.z % uint(tileColumns)), float(tile.z / uint(tileColumns)));
+
+	// z do tile para o modo com depth buffer: diagonais mais ao fundo ficam mais longe
+	float painterDepth = (ISO_MAX_DIAGONAL - (x + y)) * ISO_SLOTS_PER_DIAGONAL;
+	float z = -1.0 + 2.0 * (painterDepth + 1.0) / (ISO_SLOTS_PER_DIAGONAL * (ISO_MAX_DIAGONAL + 1.0) + 1.0);
+
+	vertexColor = vec3(1.0);
+	texcoord = tileRect.xy + (frame + corner + 0.5) * frameSize * tileRect.zw;
+	layerCoord = corner + 0.5;
+	layer = float(tile.z);
+	gl_Position = projection * view * vec4(center + corner * tileSize, z, 1.0);
+}
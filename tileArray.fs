@@ -0,0 +1,16 @@
+#version 400
+
+in vec2 layerCoord;
+flat in float layer;
+
+uniform sampler2DArray tileLayers;
+uniform float alphaCutoff;	// Com o teste de profundidade ligado, pixels transparentes não podem gravar profundidade
+
+out vec4 color;
+void main()
+{
+	// Cada frame do tileset é uma camada: a filtragem e as mipmaps nunca pegam pixels do frame vizinho
+	color = texture(tileLayers, vec3(layerCoord, layer));
+	if (color.a < alphaCutoff)
+		discard;
+}
@@ -0,0 +1,359 @@
+// Ferramenta offline que empacota as imagens do jogo em um ou poucos atlas de textura e grava o manifesto
+// lido pelo TextureCache::loadAtlas. Com o atlas carregado, os sprites e o tilemap usam a mesma textura
+// e o frame inteiro é desenhado com um único vínculo de textura.
+//
+// Compilação (Prompt de Comando do Desenvolvedor do Visual Studio, na raiz do projeto):
+//   cl /EHsc /O2 /std:c++17 /I. /IInclude tools\AtlasPacker.cpp AtlasManifest.cpp stb_image.cpp /Fe:AtlasPacker.exe
+//
+// Uso (na raiz do projeto, para que os nomes das regiões sejam os mesmos caminhos usados pelo jogo):
+//   AtlasPacker [--max-size 4096] [--padding 2] Assets/atlas Assets/Character/CharacterSheet_CharacterFront.png Assets/Util/PotionsSheet.png Assets/Tileset/spritesheet.png
+// Pastas também são aceitas e têm todos os .png empacotados. A saída gera Assets/atlas.txt e Assets/atlas0.tga, atlas1.tga...
+
+#include "AtlasManifest.h"
+#include <stb_image.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Imagem de entrada decodificada em RGBA
+struct SourceImage {
+    std::string name;               // Caminho da imagem, com '/' como separador
+    int width = 0, height = 0;
+    std::vector<unsigned char> pixels;
+    int page = -1;                  // Página e posição (com o preenchimento) escolhidas pelo empacotador
+    int x = 0, y = 0;
+};
+
+// Empacotador skyline: guarda o contorno superior dos retângulos já colocados como uma sequência de
+// segmentos horizontais e coloca cada retângulo no ponto em que o topo dele fica mais baixo (bottom-left)
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height) : width(width), height(height) {
+        skyline.push_back(Segment{ 0, 0, width });
+    }
+
+    // Procura uma posição para o retângulo; retorna false se ele não couber
+    bool insert(int rectWidth, int rectHeight, int& outX, int& outY) {
+        int bestIndex = -1, bestTop = height + 1, bestSegmentWidth = width + 1;
+        for (size_t i = 0; i < skyline.size(); ++i) {
+            int y;
+            if (!fits(i, rectWidth, rectHeight, y)) {
+                continue;
+            }
+            int top = y + rectHeight;
+            if (top < bestTop || (top == bestTop && skyline[i].width < bestSegmentWidth)) {
+                bestIndex = static_cast<int>(i);
+                bestTop = top;
+                bestSegmentWidth = skyline[i].width;
+                outX = skyline[i].x;
+                outY = y;
+            }
+        }
+        if (bestIndex < 0) {
+            return false;
+        }
+        place(bestIndex, outX, outY + rectHeight, rectWidth);
+        usedWidth = std::max(usedWidth, outX + rectWidth);
+        usedHeight = std::max(usedHeight, outY + rectHeight);
+        return true;
+    }
+
+    // Métodos para obter a área efetivamente ocupada
+    int getUsedWidth() const { return usedWidth; }
+    int getUsedHeight() const { return usedHeight; }
+
+private:
+    // Segmento do contorno: começa em x, tem a largura informada e está na altura y
+    struct Segment {
+        int x, y, width;
+    };
+
+    // Verifica se o retângulo cabe começando no segmento 'index' e calcula a altura em que ele fica
+    bool fits(size_t index, int rectWidth, int rectHeight, int& y) const {
+        int x = skyline[index].x;
+        if (x + rectWidth > width) {
+            return false;
+        }
+        y = 0;
+        int remaining = rectWidth;
+        for (size_t i = index; remaining > 0; ++i) {
+            y = std::max(y, skyline[i].y);
+            if (y + rectHeight > height) {
+                return false;
+            }
+            remaining -= skyline[i].width;
+        }
+        return true;
+    }
+
+    // Sobe o contorno em [x, x + rectWidth) até 'top', encurtando ou removendo os segmentos cobertos
+    void place(int index, int x, int top, int rectWidth) {
+        skyline.insert(skyline.begin() + index, Segment{ x, top, rectWidth });
+        int end = x + rectWidth;
+        for (size_t i = index + 1; i < skyline.size();) {
+            Segment& segment = skyline[i];
+            if (segment.x >= end) {
+                break;
+            }
+            int shrink = end - segment.x;
+            if (shrink >= segment.width) {
+                skyline.erase(skyline.begin() + i);
+                continue;
+            }
+            segment.x += shrink;
+            segment.width -= shrink;
+            break;
+        }
+        // Junta segmentos vizinhos na mesma altura
+        for (size_t i = 0; i + 1 < skyline.size();) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+    int width, height;                  // Tamanho máximo da página
+    int usedWidth = 0, usedHeight = 0;  // Área ocupada
+    std::vector<Segment> skyline;       // Contorno, ordenado por x
+};
+
+// Função que grava uma imagem RGBA em TGA de 32 bits com compressão RLE e origem no canto superior esquerdo
+// O stb_image lê TGA direto, sem a descompressão zlib de um PNG
+static bool writeTga(const std::string& path, int width, int height, const std::vector<unsigned char>& rgba) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create atlas page: " << path << std::endl;
+        return false;
+    }
+
+    unsigned char header[18] = {};
+    header[2] = 10;                                 // True color com RLE
+    header[12] = static_cast<unsigned char>(width & 0xff);
+    header[13] = static_cast<unsigned char>(width >> 8);
+    header[14] = static_cast<unsigned char>(height & 0xff);
+    header[15] = static_cast<unsigned char>(height >> 8);
+    header[16] = 32;                                // Bits por pixel
+    header[17] = 0x28;                              // 8 bits de alfa, origem no canto superior esquerdo
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    std::vector<unsigned char> packet;
+    auto pixelAt = [&](int x, int y) { return &rgba[(static_cast<size_t>(y) * width + x) * 4]; };
+    auto appendBgra = [&](const unsigned char* p) {
+        packet.push_back(p[2]);
+        packet.push_back(p[1]);
+        packet.push_back(p[0]);
+        packet.push_back(p[3]);
+    };
+
+    // Pacotes de até 128 pixels, sem atravessar linhas: repetições viram um pacote RLE, o resto vai cru
+    for (int y = 0; y < height; ++y) {
+        int x = 0;
+        while (x < width) {
+            int run = 1;
+            while (x + run < width && run < 128 && std::memcmp(pixelAt(x, y), pixelAt(x + run, y), 4) == 0) {
+                ++run;
+            }
+            packet.clear();
+            if (run > 1) {
+                packet.push_back(static_cast<unsigned char>(0x80 | (run - 1)));
+                appendBgra(pixelAt(x, y));
+                x += run;
+            }
+            else {
+                int count = 0;
+                packet.push_back(0);
+                while (x < width && count < 128
+                    && (x + 1 >= width || std::memcmp(pixelAt(x, y), pixelAt(x + 1, y), 4) != 0)) {
+                    appendBgra(pixelAt(x, y));
+                    ++x;
+                    ++count;
+                }
+                packet[0] = static_cast<unsigned char>(count - 1);
+            }
+            file.write(reinterpret_cast<const char*>(packet.data()), packet.size());
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+// Função que copia a imagem para a página e repete as bordas dela no preenchimento,
+// assim a amostragem na borda de um frame nunca pega pixels da imagem vizinha
+static void blit(const SourceImage& image, int padding, int pageWidth, std::vector<unsigned char>& page) {
+    int paddedWidth = image.width + 2 * padding;
+    int paddedHeight = image.height + 2 * padding;
+    for (int y = 0; y < paddedHeight; ++y) {
+        int sourceY = std::min(std::max(y - padding, 0), image.height - 1);
+        for (int x = 0; x < paddedWidth; ++x) {
+            int sourceX = std::min(std::max(x - padding, 0), image.width - 1);
+            const unsigned char* source = &image.pixels[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4];
+            unsigned char* target = &page[(static_cast<size_t>(image.y + y) * pageWidth + image.x + x) * 4];
+            std::memcpy(target, source, 4);
+        }
+    }
+}
+
+// Função que junta os caminhos de entrada, expandindo pastas para os .png contidos nelas
+static bool collectInputs(const std::vector<std::string>& arguments, std::vector<std::string>& paths) {
+    namespace fs = std::filesystem;
+    for (const std::string& argument : arguments) {
+        std::error_code error;
+        if (fs::is_directory(argument, error)) {
+            std::vector<std::string> found;
+            for (const fs::directory_entry& entry : fs::recursive_directory_iterator(argument, error)) {
+                std::string extension = entry.path().extension().string();
+                std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                if (entry.is_regular_file() && extension == ".png") {
+                    found.push_back(entry.path().generic_string());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            paths.insert(paths.end(), found.begin(), found.end());
+        }
+        else if (fs::is_regular_file(argument, error)) {
+            paths.push_back(fs::path(argument).generic_string());
+        }
+        else {
+            std::cerr << "Input not found: " << argument << std::endl;
+            return false;
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return !paths.empty();
+}
+
+int main(int argc, char** argv) {
+    int maxSize = 4096;
+    int padding = 2;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if ((argument == "--max-size" || argument == "--padding") && i + 1 < argc) {
+            (argument == "--max-size" ? maxSize : padding) = std::atoi(argv[++i]);
+        }
+        else {
+            arguments.push_back(argument);
+        }
+    }
+    if (arguments.size() < 2 || maxSize <= 0 || padding < 0) {
+        std::cerr << "Usage: " << argv[0] << " [--max-size N] [--padding N] <output prefix> <image or folder>..." << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string prefix = arguments[0];
+    std::vector<std::string> paths;
+    if (!collectInputs(std::vector<std::string>(arguments.begin() + 1, arguments.end()), paths)) {
+        return 1;
+    }
+
+    // Decodifica as imagens em RGBA, na orientação do arquivo (o jogo inverte ao carregar a página)
+    std::vector<SourceImage> images;
+    for (const std::string& path : paths) {
+        SourceImage image;
+        int channels;
+        unsigned char* data = stbi_load(path.c_str(), &image.width, &image.height, &channels, 4);
+        if (!data) {
+            std::cerr << "Failed to load image: " << path << std::endl;
+            return 1;
+        }
+        image.name = path;
+        image.pixels.assign(data, data + static_cast<size_t>(image.width) * image.height * 4);
+        stbi_image_free(data);
+        if (image.width + 2 * padding > maxSize || image.height + 2 * padding > maxSize) {
+            std::cerr << "Image does not fit in a " << maxSize << "x" << maxSize << " page: " << path << std::endl;
+            return 1;
+        }
+        images.push_back(std::move(image));
+    }
+
+    // Empacota das imagens mais altas para as mais baixas, abrindo uma página nova quando nenhuma comporta a imagem
+    std::vector<SourceImage*> order;
+    for (SourceImage& image : images) {
+        order.push_back(&image);
+    }
+    std::sort(order.begin(), order.end(), [](const SourceImage* a, const SourceImage* b) {
+        return a->height != b->height ? a->height > b->height : a->width > b->width;
+        });
+
+    std::vector<SkylinePacker> packers;
+    for (SourceImage* image : order) {
+        int paddedWidth = image->width + 2 * padding;
+        int paddedHeight = image->height + 2 * padding;
+        for (size_t page = 0; page <= packers.size(); ++page) {
+            if (page == packers.size()) {
+                packers.emplace_back(maxSize, maxSize);
+            }
+            if (packers[page].insert(paddedWidth, paddedHeight, image->x, image->y)) {
+                image->page = static_cast<int>(page);
+                break;
+            }
+        }
+    }
+
+    // Monta e grava as páginas, cortadas na área ocupada
+    AtlasManifest manifest;
+    size_t usedPixels = 0, pagePixels = 0;
+    for (size_t page = 0; page < packers.size(); ++page) {
+        AtlasPage atlasPage;
+        atlasPage.path = prefix + std::to_string(page) + ".tga";
+        atlasPage.width = packers[page].getUsedWidth();
+        atlasPage.height = packers[page].getUsedHeight();
+
+        std::vector<unsigned char> pixels(static_cast<size_t>(atlasPage.width) * atlasPage.height * 4, 0);
+        for (const SourceImage& image : images) {
+            if (image.page == static_cast<int>(page)) {
+                blit(image, padding, atlasPage.width, pixels);
+                usedPixels += static_cast<size_t>(image.width) * image.height;
+            }
+        }
+        if (!writeTga(atlasPage.path, atlasPage.width, atlasPage.height, pixels)) {
+            return 1;
+        }
+        pagePixels += static_cast<size_t>(atlasPage.width) * atlasPage.height;
+        manifest.pages.push_back(atlasPage);
+    }
+
+    for (const SourceImage& image : images) {
+        AtlasRegion region;
+        region.name = image.name;
+        region.page = image.page;
+        region.x = image.x + padding;
+        region.y = image.y + padding;
+        region.width = image.width;
+        region.height = image.height;
+        manifest.regions.push_back(region);
+    }
+
+    std::string manifestPath = prefix + ".txt";
+    if (!writeAtlasManifest(manifestPath, manifest)) {
+        return 1;
+    }
+
+    // Relê o manifesto gerado para garantir que o jogo conseguirá carregá-lo
+    AtlasManifest check;
+    if (!loadAtlasManifest(manifestPath, check) || check.regions.size() != manifest.regions.size()) {
+        std::cerr << "Verification of " << manifestPath << " failed" << std::endl;
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Packed " << images.size() << " images into " << manifest.pages.size() << " page(s), "
+        << (pagePixels ? 100.0 * usedPixels / pagePixels : 0.0) << "% used, manifest " << manifestPath
+        << " in " << elapsed << " ms" << std::endl;
+    for (const AtlasPage& page : manifest.pages) {
+        std::cout << "  " << page.path << " " << page.width << "x" << page.height << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Ferramenta offline que converte um mapa no formato texto (map.txt) para o formato binário (.gbmap)
+// lido pelo Tilemap via mapeamento em memória.
+//
+// Compilação (Prompt de Comando do Desenvolvedor do Visual Studio, na raiz do projeto):
+//   cl /EHsc /O2 /std:c++17 /I. tools\MapConverter.cpp MapFile.cpp TileGrid.cpp /Fe:MapConverter.exe
+//
+// Uso:
+//   MapConverter Assets/map.txt Assets/map.gbmap
+
+#include "MapFile.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input map.txt> <output .gbmap>" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    MapDescription map;
+    if (!loadTextMap(argv[1], map)) {
+        return 1;
+    }
+    if (map.grid.size() == 0) {
+        std::cerr << "Map has no tiles: " << argv[1] << std::endl;
+        return 1;
+    }
+    if (!writeBinaryMap(argv[2], map)) {
+        return 1;
+    }
+
+    // Relê o arquivo gerado para garantir que o Tilemap conseguirá carregá-lo
+    MappedFile file;
+    MapDescription check;
+    if (!loadBinaryMap(argv[2], file, check) || check.grid.size() != map.grid.size()
+        || !std::equal(map.grid.data(), map.grid.data() + map.grid.size(), check.grid.data())) {
+        std::cerr << "Verification of " << argv[2] << " failed" << std::endl;
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Converted " << map.grid.getWidth() << "x" << map.grid.getHeight() << " map with "
+        << map.properties.size() << " tile properties to " << argv[2] << " in " << elapsed << " ms" << std::endl;
+    return 0;
+}